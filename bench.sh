@@ -0,0 +1,32 @@
+#!/bin/bash
+#
+# Time each scheduler on synthetic workloads of the given sizes
+#
+#   ./bench.sh [# of processes ...]
+#
+# Workloads are generated by wlgen into $BENCH_DIR (/tmp by default) and
+# reused across runs. Half of the processes are periodic with deadlines for
+# -d and -t. Set WLGEN_FLAGS to shape them, and SCHEDULERS to pick
+# the schedulers (e.g., SCHEDULERS="a P"). -P scans every ready process on
+# every tick, so it is left out by default. Set SCHED to time another build
+# (e.g., SCHED=./sched-spec).
+
+SIZES=${@:-1000 100000 10000000}
+SCHEDULERS=${SCHEDULERS:-f s S r m p a c i d t}
+SCHED=${SCHED:-./sched}
+BENCH_DIR=${BENCH_DIR:-/tmp}
+WLGEN_FLAGS=${WLGEN_FLAGS:--r 4 -c 0.2 -e 0.5 -d 0.3}
+
+cd "$(dirname "$0")" || exit 1
+
+for size in $SIZES; do
+	workload="$BENCH_DIR/sched-bench-$size.wl"
+
+	./wlgen -n "$size" $WLGEN_FLAGS "$workload" || exit 1
+
+	echo "# $size processes"
+	for s in $SCHEDULERS; do
+		$SCHED -q -B -e -$s "$workload" 2>/dev/null || echo "-$s failed"
+	done
+	echo
+done
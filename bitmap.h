@@ -0,0 +1,73 @@
+/**********************************************************************
+ * Copyright (c) 2019-2021
+ *  Sang-Hoon Kim <sanghoonkim@ajou.ac.kr>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTIABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ **********************************************************************/
+
+#ifndef __BITMAP_H__
+#define __BITMAP_H__
+
+#include <limits.h>
+
+/**
+ * Bitmap of @nbits bits in an array of unsigned longs. Iterating it with
+ * for_each_set_bit() visits the set bits only, skipping a long at a time
+ */
+#define BITS_PER_LONG		(sizeof(unsigned long) * CHAR_BIT)
+#define BITS_TO_LONGS(nbits)	(((nbits) + BITS_PER_LONG - 1) / BITS_PER_LONG)
+
+static inline void set_bit(unsigned long *map, unsigned int bit)
+{
+	map[bit / BITS_PER_LONG] |= 1UL << (bit % BITS_PER_LONG);
+}
+
+static inline void clear_bit(unsigned long *map, unsigned int bit)
+{
+	map[bit / BITS_PER_LONG] &= ~(1UL << (bit % BITS_PER_LONG));
+}
+
+static inline bool test_bit(const unsigned long *map, unsigned int bit)
+{
+	return (map[bit / BITS_PER_LONG] >> (bit % BITS_PER_LONG)) & 1;
+}
+
+/**
+ * find_next_bit - the first set bit at @bit or after it. @nbits if none
+ */
+static inline unsigned int find_next_bit(const unsigned long *map,
+		unsigned int nbits, unsigned int bit)
+{
+	unsigned int i = bit / BITS_PER_LONG;
+	unsigned long word;
+
+	if (bit >= nbits) return nbits;
+
+	word = map[i] & (~0UL << (bit % BITS_PER_LONG));
+	while (!word) {
+		if (++i >= BITS_TO_LONGS(nbits)) return nbits;
+		word = map[i];
+	}
+	bit = i * BITS_PER_LONG + __builtin_ctzl(word);
+	return bit < nbits ? bit : nbits;
+}
+
+/**
+ * for_each_set_bit - iterate over the set bits of @map
+ * @bit:	the unsigned int to use as a loop cursor
+ * @map:	the bitmap
+ * @nbits:	# of bits in @map
+ */
+#define for_each_set_bit(bit, map, nbits) \
+	for ((bit) = find_next_bit((map), (nbits), 0); (bit) < (nbits); \
+			(bit) = find_next_bit((map), (nbits), (bit) + 1))
+
+#endif
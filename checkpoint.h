@@ -0,0 +1,136 @@
+/**********************************************************************
+ * Copyright (c) 2019-2021
+ *  Sang-Hoon Kim <sanghoonkim@ajou.ac.kr>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTIABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ **********************************************************************/
+
+#ifndef __CHECKPOINT_H__
+#define __CHECKPOINT_H__
+
+#include <stdint.h>
+
+/**
+ * Checkpoint image
+ *
+ * A checkpoint is the state of a simulation at the beginning of a tick,
+ * before forking the processes of the tick. "sched -K <tick>:<image>" stops
+ * the simulation at @tick and writes the image, and "sched -R <image>"
+ * continues the simulation from there. It is laid out as;
+ *
+ *   struct checkpoint_header
+ *   struct checkpoint_process   processes[header.nr_processes]
+ *   struct checkpoint_acquire   acquires[header.nr_acquires]
+ *   uint32_t                    owned[header.nr_owned]
+ *   struct checkpoint_resource  resources[header.nr_resources]
+ *   struct checkpoint_waiter    waiters[header.nr_waiters]
+ *   struct checkpoint_cpu       cpus[header.nr_cpus]
+ *   uint32_t                    ready[header.nr_ready]
+ *   the metrics collected so far. See metrics_save()
+ *
+ * @processes are the @nr_live processes forked and not exited yet, followed
+ * by the ones to fork in the order to fork them. The other sections refer to
+ * a process by its index in @processes, and to a resource by its index in
+ * @resources. Each process owns @nr_acquires entries of @acquires in order;
+ * the resources to acquire sorted by @at, and then the ones it holds in the
+ * order to release them. Each live process also owns @nr_owned entries of
+ * @owned, which are the resources it owns in the order it acquired them.
+ *
+ * Each resource owns @nr_waiters entries of @waiters in the order to wake
+ * them up. Each CPU owns @nr_ready entries of @ready, which are the ready
+ * processes in the order to put them back into the ready queue.
+ *
+ * All the fields are in the host byte order, and the image is only for the
+ * build of the simulator that wrote it.
+ */
+#define CHECKPOINT_MAGIC		"SCHEDCK2"
+#define CHECKPOINT_MAGIC_LEN	8
+
+#define CHECKPOINT_NONE			UINT32_MAX	/* No process or resource */
+
+struct checkpoint_header {
+	char magic[CHECKPOINT_MAGIC_LEN];
+	uint32_t sched;			/* Flag selecting the scheduler (e.g., 'f') */
+	uint32_t rr_quantum;
+	uint32_t pa_aging_period;
+	uint32_t ticks;
+	uint32_t cpu_width;		/* Columns for each CPU in the output */
+	uint32_t nr_cpus;
+	uint32_t nr_live;
+	uint32_t nr_processes;
+	uint32_t nr_acquires;
+	uint32_t nr_owned;
+	uint32_t nr_resources;
+	uint32_t nr_waiters;
+	uint32_t nr_ready;
+};
+
+struct checkpoint_process {
+	uint32_t pid;
+	uint32_t status;
+	uint32_t age;
+	uint32_t lifespan;
+	uint32_t prio;
+	uint32_t prio_orig;
+	uint32_t cpu;
+	uint32_t slice_start;
+	uint32_t level;
+	uint32_t boosted_at;
+	uint32_t period;
+	uint32_t deadline;
+	uint32_t deadline_at;
+	uint32_t dl_key;
+	uint32_t blocked_on;	/* Resource, or CHECKPOINT_NONE */
+	uint32_t starts_at;
+	uint32_t forked_at;
+	uint32_t first_run_at;
+	uint32_t blocked_ticks;
+	uint32_t waiting_since;
+	uint32_t waiting_ticks;
+	uint32_t nr_acquires;
+	uint32_t nr_owned;
+};
+
+#define CHECKPOINT_HOLDING		0x1	/* Acquired and to release */
+#define CHECKPOINT_CONTENDED	0x2	/* Failed to acquire at the first try */
+
+struct checkpoint_acquire {
+	uint32_t resource;
+	int32_t at;
+	int32_t duration;
+	uint32_t flags;
+	uint32_t blocked_at;
+	uint32_t acquired_at;
+};
+
+struct checkpoint_resource {
+	int32_t id;				/* Resource id in the script */
+	uint32_t ceiling;
+	uint32_t owner;			/* Process, or CHECKPOINT_NONE */
+	uint32_t nr_waiters;
+};
+
+#define CHECKPOINT_WAITER_HEAP	0x1	/* In resource->waiters, not waitqueue */
+
+struct checkpoint_waiter {
+	uint32_t process;
+	uint32_t flags;
+	uint32_t key;			/* Key in resource->waiters */
+};
+
+struct checkpoint_cpu {
+	uint32_t current;		/* Process, or CHECKPOINT_NONE */
+	uint32_t busy_ticks;
+	uint32_t nr_ready;
+	uint32_t state;			/* What scheduler->save() returned */
+};
+
+#endif
@@ -0,0 +1,136 @@
+/**********************************************************************
+ * Copyright (c) 2019-2021
+ *  Sang-Hoon Kim <sanghoonkim@ajou.ac.kr>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTIABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ **********************************************************************/
+
+#include <stdlib.h>
+#include <assert.h>
+
+#include "types.h"
+#include "heap.h"
+
+static inline bool __heap_less(const struct heap_node *a, const struct heap_node *b)
+{
+	if (a->key != b->key) return a->key < b->key;
+	return a->seq < b->seq;
+}
+
+static inline void __heap_set(struct heap *h, unsigned int index, struct heap_node *node)
+{
+	h->nodes[index] = node;
+	node->index = index;
+}
+
+static void __heap_sift_up(struct heap *h, unsigned int index)
+{
+	struct heap_node *node = h->nodes[index];
+
+	while (index > 0) {
+		unsigned int parent = (index - 1) / 2;
+		if (!__heap_less(node, h->nodes[parent])) break;
+
+		__heap_set(h, index, h->nodes[parent]);
+		index = parent;
+	}
+	__heap_set(h, index, node);
+}
+
+static void __heap_sift_down(struct heap *h, unsigned int index)
+{
+	struct heap_node *node = h->nodes[index];
+
+	while (true) {
+		unsigned int child = index * 2 + 1;
+		if (child >= h->nr) break;
+
+		if (child + 1 < h->nr && __heap_less(h->nodes[child + 1], h->nodes[child])) {
+			child++;
+		}
+		if (!__heap_less(h->nodes[child], node)) break;
+
+		__heap_set(h, index, h->nodes[child]);
+		index = child;
+	}
+	__heap_set(h, index, node);
+}
+
+void heap_init(struct heap *h)
+{
+	h->nodes = NULL;
+	h->nr = 0;
+	h->size = 0;
+	h->seq = 0;
+}
+
+void heap_destroy(struct heap *h)
+{
+	free(h->nodes);
+	heap_init(h);
+}
+
+void heap_push(struct heap *h, struct heap_node *node, unsigned long key)
+{
+	if (h->nr == h->size) {
+		h->size = h->size ? h->size * 2 : 16;
+		h->nodes = realloc(h->nodes, sizeof(*h->nodes) * h->size);
+		assert(h->nodes);
+	}
+
+	node->key = key;
+	node->seq = h->seq++;
+
+	h->nodes[h->nr] = node;
+	__heap_sift_up(h, h->nr++);
+}
+
+void heap_remove(struct heap *h, struct heap_node *node)
+{
+	unsigned int index = node->index;
+	struct heap_node *last;
+
+	assert(heap_contains(h, node));
+
+	last = h->nodes[--h->nr];
+	if (last == node) return;
+
+	/* Fill the hole with the last node, and put it back in order */
+	__heap_set(h, index, last);
+	if (index > 0 && __heap_less(last, h->nodes[(index - 1) / 2])) {
+		__heap_sift_up(h, index);
+	} else {
+		__heap_sift_down(h, index);
+	}
+}
+
+void heap_update(struct heap *h, struct heap_node *node, unsigned long key)
+{
+	unsigned int index = node->index;
+
+	assert(heap_contains(h, node));
+
+	node->key = key;
+	if (index > 0 && __heap_less(node, h->nodes[(index - 1) / 2])) {
+		__heap_sift_up(h, index);
+	} else {
+		__heap_sift_down(h, index);
+	}
+}
+
+struct heap_node *heap_pop(struct heap *h)
+{
+	struct heap_node *node = heap_peek(h);
+
+	if (node) heap_remove(h, node);
+
+	return node;
+}
@@ -0,0 +1,86 @@
+/**********************************************************************
+ * Copyright (c) 2019-2021
+ *  Sang-Hoon Kim <sanghoonkim@ajou.ac.kr>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTIABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ **********************************************************************/
+
+#ifndef __HEAP_H__
+#define __HEAP_H__
+
+/**
+ * Intrusive binary min-heap. Embed struct heap_node in the structure to
+ * keep in a heap, and get the structure back from a node with container_of()
+ * as with struct list_head.
+ *
+ * Nodes are ordered by @key. Nodes with the same key come out in the order
+ * they were pushed, so a heap can replace a FIFO list scanned for the minimum.
+ */
+struct heap_node {
+	unsigned long key;
+	unsigned long seq;		/* Push order to break ties of @key */
+	unsigned int index;		/* Position in heap->nodes */
+};
+
+struct heap {
+	struct heap_node **nodes;
+	unsigned int nr;		/* # of nodes in the heap */
+	unsigned int size;		/* # of slots allocated for @nodes */
+	unsigned long seq;
+};
+
+void heap_init(struct heap *h);
+void heap_destroy(struct heap *h);
+
+/**
+ * heap_push - put @node into @h with @key
+ */
+void heap_push(struct heap *h, struct heap_node *node, unsigned long key);
+
+/**
+ * heap_pop - take out the node with the smallest key. NULL if @h is empty
+ */
+struct heap_node *heap_pop(struct heap *h);
+
+/**
+ * heap_remove - take @node, which is in @h, out of @h
+ */
+void heap_remove(struct heap *h, struct heap_node *node);
+
+/**
+ * heap_update - change the key of @node, which is in @h, to @key. The push
+ * order of @node is not refreshed, so it breaks ties with the nodes of the
+ * same key by when it was pushed in the first place, not by the update
+ */
+void heap_update(struct heap *h, struct heap_node *node, unsigned long key);
+
+/**
+ * heap_contains - tell whether @node is in @h
+ */
+static inline bool heap_contains(const struct heap *h, const struct heap_node *node)
+{
+	return node->index < h->nr && h->nodes[node->index] == node;
+}
+
+static inline bool heap_empty(const struct heap *h)
+{
+	return h->nr == 0;
+}
+
+/**
+ * heap_peek - the node with the smallest key without taking it out
+ */
+static inline struct heap_node *heap_peek(const struct heap *h)
+{
+	return h->nr ? h->nodes[0] : NULL;
+}
+
+#endif
@@ -0,0 +1,416 @@
+/**********************************************************************
+ * Copyright (c) 2019-2021
+ *  Sang-Hoon Kim <sanghoonkim@ajou.ac.kr>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTIABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ **********************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+#include "types.h"
+#include "list_head.h"
+#include "heap.h"
+#include "bitmap.h"
+#include "process.h"
+#include "resource.h"
+#include "metrics.h"
+
+__thread unsigned long nr_context_switches = 0;
+
+/**
+ * Samples are kept metric by metric to be sorted separately, only when
+ * asked with metrics_keep_samples(). The sums are kept always
+ */
+static bool __keep_samples = false;
+static __thread unsigned int *__samples[NR_METRICS];
+static __thread unsigned int __nr_samples;
+static __thread unsigned int __nr_slots;
+
+static __thread unsigned long __sums[NR_METRICS];
+
+struct resource_stat {
+	unsigned long nr_acquisitions;
+	unsigned long nr_contended;		/* # of acquisitions after waiting */
+	unsigned long wait_ticks;
+	unsigned int max_wait;
+	unsigned long hold_ticks;
+	unsigned long inversion_ticks;	/* Ticks in a priority inversion */
+
+	int owner_prio;					/* -1 if not owned */
+	unsigned int nr_waiters[MAX_PRIO + 1];
+									/* # of waiters at each priority */
+	bool inverted;
+	unsigned int inverted_since;
+};
+
+/**
+ * Deadlines of the processes having one
+ */
+struct deadline_stat {
+	unsigned int nr_deadlines;		/* # of processes exited with a deadline */
+	unsigned int nr_missed;
+	unsigned long tardiness;		/* Sum of the ticks exited late */
+	unsigned int max_tardiness;
+	unsigned int nr_rejected;		/* # of processes not admitted */
+};
+
+static __thread struct deadline_stat __deadlines;
+
+static __thread struct resource_stat *__resource_stats;
+static __thread unsigned int __nr_resource_stats;
+
+/**
+ * Resources ever acquired, which are the ones to print
+ */
+static __thread unsigned long *__used_resources;
+
+extern __thread struct resource *resources;
+
+static const char *__metric_names[NR_METRICS] = {
+	"Response",
+	"Turnaround",
+	"Blocked",
+	"Waiting",
+	"Ready",
+};
+
+void metrics_init(void)
+{
+	for (int i = 0; i < NR_METRICS; i++) {
+		__samples[i] = NULL;
+		__sums[i] = 0;
+	}
+	__nr_samples = 0;
+	__nr_slots = 0;
+	nr_context_switches = 0;
+	__deadlines = (struct deadline_stat) { 0 };
+
+	__resource_stats = NULL;
+	__nr_resource_stats = 0;
+	__used_resources = NULL;
+}
+
+void metrics_keep_samples(bool keep)
+{
+	__keep_samples = keep;
+}
+
+void metrics_init_resources(unsigned int nr)
+{
+	__resource_stats = malloc(sizeof(*__resource_stats) * nr);
+	__used_resources = calloc(BITS_TO_LONGS(nr), sizeof(*__used_resources));
+	assert((__resource_stats && __used_resources) || !nr);
+
+	for (unsigned int i = 0; i < nr; i++) {
+		__resource_stats[i] = (struct resource_stat) {
+			.owner_prio = -1,
+		};
+	}
+	__nr_resource_stats = nr;
+}
+
+void metrics_destroy(void)
+{
+	for (int i = 0; i < NR_METRICS; i++) {
+		free(__samples[i]);
+	}
+	free(__resource_stats);
+	free(__used_resources);
+	metrics_init();
+}
+
+/**
+ * Leads the buffer of metrics_save(), which is followed by the samples of
+ * each metric and then the statistics of the resources
+ */
+struct metrics_image {
+	unsigned int nr_samples;
+	unsigned int nr_resources;
+	unsigned long nr_context_switches;
+	struct deadline_stat deadlines;
+};
+
+void *metrics_save(size_t *size)
+{
+	struct metrics_image header = {
+		.nr_samples = __nr_samples,
+		.nr_resources = __nr_resource_stats,
+		.nr_context_switches = nr_context_switches,
+		.deadlines = __deadlines,
+	};
+	size_t samples_size = sizeof(**__samples) * __nr_samples;
+	char *image, *pos;
+
+	assert(__keep_samples);
+
+	*size = sizeof(header) + samples_size * NR_METRICS
+			+ sizeof(*__resource_stats) * __nr_resource_stats;
+	image = malloc(*size);
+	assert(image);
+
+	memcpy(image, &header, sizeof(header));
+	pos = image + sizeof(header);
+
+	for (int i = 0; i < NR_METRICS && samples_size; i++, pos += samples_size) {
+		memcpy(pos, __samples[i], samples_size);
+	}
+	if (__nr_resource_stats) {
+		memcpy(pos, __resource_stats, sizeof(*__resource_stats) * __nr_resource_stats);
+	}
+	return image;
+}
+
+bool metrics_restore(const void *image, size_t size)
+{
+	struct metrics_image header;
+	const char *samples = (const char *)image + sizeof(header);
+	unsigned int values[NR_METRICS];
+
+	if (size < sizeof(header)) return false;
+	memcpy(&header, image, sizeof(header));
+
+	if (header.nr_resources > __nr_resource_stats ||
+			size != sizeof(header) + sizeof(**__samples) * header.nr_samples * NR_METRICS
+				+ sizeof(*__resource_stats) * header.nr_resources) {
+		return false;
+	}
+
+	for (unsigned int n = 0; n < header.nr_samples; n++) {
+		for (int i = 0; i < NR_METRICS; i++) {
+			memcpy(values + i, samples + sizeof(*values) * (header.nr_samples * i + n),
+					sizeof(*values));
+		}
+		metrics_record(values);
+	}
+
+	if (header.nr_resources) {
+		memcpy(__resource_stats, samples + sizeof(*values) * header.nr_samples * NR_METRICS,
+				sizeof(*__resource_stats) * header.nr_resources);
+	}
+	for (unsigned int i = 0; i < header.nr_resources; i++) {
+		if (__resource_stats[i].nr_acquisitions) set_bit(__used_resources, i);
+	}
+
+	nr_context_switches = header.nr_context_switches;
+	__deadlines = header.deadlines;
+	return true;
+}
+
+void metrics_record(const unsigned int values[NR_METRICS])
+{
+	if (!__keep_samples) {
+		for (int i = 0; i < NR_METRICS; i++) {
+			__sums[i] += values[i];
+		}
+		__nr_samples++;
+		return;
+	}
+
+	if (__nr_samples == __nr_slots) {
+		__nr_slots = __nr_slots ? __nr_slots * 2 : 64;
+		for (int i = 0; i < NR_METRICS; i++) {
+			__samples[i] = realloc(__samples[i], sizeof(*__samples[i]) * __nr_slots);
+			assert(__samples[i]);
+		}
+	}
+
+	for (int i = 0; i < NR_METRICS; i++) {
+		__samples[i][__nr_samples] = values[i];
+		__sums[i] += values[i];
+	}
+	__nr_samples++;
+}
+
+void metrics_deadline(unsigned int deadline_at, unsigned int now)
+{
+	__deadlines.nr_deadlines++;
+
+	if (now <= deadline_at) return;
+
+	__deadlines.nr_missed++;
+	__deadlines.tardiness += now - deadline_at;
+	if (now - deadline_at > __deadlines.max_tardiness) {
+		__deadlines.max_tardiness = now - deadline_at;
+	}
+}
+
+void metrics_deadline_rejected(void)
+{
+	__deadlines.nr_rejected++;
+}
+
+unsigned int metrics_nr_samples(void)
+{
+	return __nr_samples;
+}
+
+double metrics_average(enum metric metric)
+{
+	return __nr_samples ? (double)__sums[metric] / __nr_samples : 0.0;
+}
+
+static int __compare_samples(const void *a, const void *b)
+{
+	unsigned int x = *(const unsigned int *)a;
+	unsigned int y = *(const unsigned int *)b;
+
+	return (x > y) - (x < y);
+}
+
+/**
+ * The nearest-rank @percent-th percentile of @sorted
+ */
+static unsigned int __percentile(const unsigned int *sorted, unsigned int percent)
+{
+	unsigned int rank = (__nr_samples * percent + 99) / 100;
+
+	return sorted[rank ? rank - 1 : 0];
+}
+
+void metrics_print(void)
+{
+	assert(__keep_samples);
+
+	printf("\n");
+	printf("%-12s %10s %8s %8s %8s %8s\n",
+			"Metric", "Average", "p50", "p95", "p99", "Max");
+
+	for (int i = 0; i < NR_METRICS; i++) {
+		unsigned int *sorted = __samples[i];
+
+		if (!__nr_samples) {
+			printf("%-12s %10s\n", __metric_names[i], "-");
+			continue;
+		}
+
+		/* Nothing is recorded any more. Sort the samples in place */
+		qsort(sorted, __nr_samples, sizeof(*sorted), __compare_samples);
+
+		printf("%-12s %10.2f %8u %8u %8u %8u\n", __metric_names[i],
+				metrics_average(i), __percentile(sorted, 50),
+				__percentile(sorted, 95), __percentile(sorted, 99),
+				sorted[__nr_samples - 1]);
+	}
+	printf("\n");
+	printf("%u processes exited, %lu context switches\n",
+			__nr_samples, nr_context_switches);
+
+	/* Scripts without deadlines print as before */
+	if (!__deadlines.nr_deadlines && !__deadlines.nr_rejected) return;
+
+	printf("%u deadlines, %u missed (%.1f%%), %.2f ticks late on average and %u at most, "
+			"%u rejected\n",
+			__deadlines.nr_deadlines, __deadlines.nr_missed,
+			__deadlines.nr_deadlines ?
+				100.0 * __deadlines.nr_missed / __deadlines.nr_deadlines : 0.0,
+			__deadlines.nr_missed ?
+				(double)__deadlines.tardiness / __deadlines.nr_missed : 0.0,
+			__deadlines.max_tardiness, __deadlines.nr_rejected);
+}
+
+
+/**
+ * The level of @prio in resource_stat->nr_waiters. Priorities above MAX_PRIO
+ * share the top level
+ */
+static inline unsigned int __prio_level(unsigned int prio)
+{
+	return prio < MAX_PRIO ? prio : MAX_PRIO;
+}
+
+/**
+ * Open or close the inversion window of @stat if it has changed at @now
+ */
+static void __update_inversion(struct resource_stat *stat, unsigned int now)
+{
+	int highest = MAX_PRIO;
+	bool inverted;
+
+	while (highest >= 0 && !stat->nr_waiters[highest]) {
+		highest--;
+	}
+	inverted = stat->owner_prio >= 0 && highest > stat->owner_prio;
+
+	if (inverted == stat->inverted) return;
+
+	if (inverted) {
+		stat->inverted_since = now;
+	} else {
+		stat->inversion_ticks += now - stat->inverted_since;
+	}
+	stat->inverted = inverted;
+}
+
+void metrics_resource_blocked(int resource_id, unsigned int prio, unsigned int now)
+{
+	struct resource_stat *stat = __resource_stats + resource_id;
+
+	stat->nr_waiters[__prio_level(prio)]++;
+	__update_inversion(stat, now);
+}
+
+void metrics_resource_acquired(int resource_id, unsigned int prio, unsigned int now,
+		bool contended, unsigned int wait)
+{
+	struct resource_stat *stat = __resource_stats + resource_id;
+
+	set_bit(__used_resources, resource_id);
+
+	stat->nr_acquisitions++;
+	if (contended) {
+		assert(stat->nr_waiters[__prio_level(prio)]);
+		stat->nr_waiters[__prio_level(prio)]--;
+
+		stat->nr_contended++;
+		stat->wait_ticks += wait;
+		if (wait > stat->max_wait) stat->max_wait = wait;
+	}
+	stat->owner_prio = __prio_level(prio);
+	__update_inversion(stat, now);
+}
+
+void metrics_resource_released(int resource_id, unsigned int now, unsigned int hold)
+{
+	struct resource_stat *stat = __resource_stats + resource_id;
+
+	stat->hold_ticks += hold;
+	stat->owner_prio = -1;
+	__update_inversion(stat, now);
+}
+
+void metrics_print_resource(int resource_id, unsigned int now)
+{
+	const struct resource_stat *stat = __resource_stats + resource_id;
+	unsigned long inversion = stat->inversion_ticks;
+
+	/* Count the inversion going on as well */
+	if (stat->inverted) inversion += now - stat->inverted_since;
+
+	printf("%8d %8lu %9lu %8lu %8u %8lu %9lu\n", resources[resource_id].id,
+			stat->nr_acquisitions, stat->nr_contended, stat->wait_ticks,
+			stat->max_wait, stat->hold_ticks, inversion);
+}
+
+void metrics_print_resources(unsigned int now)
+{
+	unsigned int i;
+
+	printf("\n");
+	printf("%8s %8s %9s %8s %8s %8s %9s\n", "Resource", "Acquired",
+			"Contended", "Wait", "MaxWait", "Hold", "Inversion");
+
+	for_each_set_bit(i, __used_resources, __nr_resource_stats) {
+		metrics_print_resource(i, now);
+	}
+}
@@ -0,0 +1,145 @@
+/**********************************************************************
+ * Copyright (c) 2019-2021
+ *  Sang-Hoon Kim <sanghoonkim@ajou.ac.kr>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTIABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ **********************************************************************/
+
+#ifndef __METRICS_H__
+#define __METRICS_H__
+
+#include <stddef.h>
+
+/**
+ * Scheduling metrics of the processes (-M).
+ *
+ * The framework keeps cheap per-process counters during the simulation and
+ * hands them over with metrics_record() when a process exits. Percentiles
+ * are computed from the recorded samples at the end of the simulation. The
+ * samples are kept only with metrics_keep_samples(), and the averages are
+ * available without them.
+ */
+enum metric {
+	METRIC_RESPONSE,	/* From the fork to the first tick on a processor */
+	METRIC_TURNAROUND,	/* From the fork to the exit */
+	METRIC_BLOCKED,		/* # of ticks blocked while acquiring resources (=) */
+	METRIC_WAITING,		/* # of ticks waiting for resources */
+	METRIC_READY,		/* # of ticks in the ready queue */
+	NR_METRICS,
+};
+
+/**
+ * # of times a processor switched from a process to another. Going idle and
+ * coming back from idle are not counted
+ */
+extern __thread unsigned long nr_context_switches;
+
+void metrics_init(void);
+void metrics_destroy(void);
+
+/**
+ * metrics_keep_samples - keep the metrics of every process for
+ * metrics_print() and metrics_save(). Set it before the simulations start,
+ * as it applies to the simulations on all threads
+ */
+void metrics_keep_samples(bool keep);
+
+/**
+ * metrics_save - put the metrics collected so far in a buffer for a
+ * checkpoint. The caller frees the returned buffer of @size bytes
+ */
+void *metrics_save(size_t *size);
+
+/**
+ * metrics_restore - bring back the metrics from @image of @size bytes, which
+ * metrics_save() made. The resources should be allocated with
+ * metrics_init_resources() beforehand. Return false if @image is corrupted
+ */
+bool metrics_restore(const void *image, size_t size);
+
+/**
+ * metrics_record - add the metrics of an exited process
+ */
+void metrics_record(const unsigned int values[NR_METRICS]);
+
+/**
+ * metrics_deadline - a process with the deadline at @deadline_at exited at
+ * @now. It missed the deadline if @now is past @deadline_at
+ */
+void metrics_deadline(unsigned int deadline_at, unsigned int now);
+
+/**
+ * metrics_deadline_rejected - a process was not admitted. See @admit in
+ * sched.h
+ */
+void metrics_deadline_rejected(void);
+
+/**
+ * metrics_nr_samples - # of processes recorded so far
+ */
+unsigned int metrics_nr_samples(void);
+
+/**
+ * metrics_average - average of @metric over the recorded processes
+ */
+double metrics_average(enum metric metric);
+
+/**
+ * metrics_print - print the average, percentiles, and maximum of each metric
+ */
+void metrics_print(void);
+
+
+/**
+ * Contention of the resources.
+ *
+ * The framework reports the acquisitions and releases of each resource with
+ * the original priority of the processes, and the tick when they happen.
+ * A priority inversion is when a process waits for a resource owned by a
+ * process with a lower (original) priority.
+ */
+
+/**
+ * metrics_init_resources - allocate the statistics of @nr resources. Called
+ * once the resource table is built for the script
+ */
+void metrics_init_resources(unsigned int nr);
+
+/**
+ * metrics_resource_blocked - a process at @prio starts waiting for @resource_id
+ */
+void metrics_resource_blocked(int resource_id, unsigned int prio, unsigned int now);
+
+/**
+ * metrics_resource_acquired - a process at @prio acquired @resource_id after
+ * waiting for @wait ticks since metrics_resource_blocked(). @contended is
+ * false if it did not wait at all
+ */
+void metrics_resource_acquired(int resource_id, unsigned int prio, unsigned int now,
+		bool contended, unsigned int wait);
+
+/**
+ * metrics_resource_released - the owner released @resource_id after holding
+ * it for @hold ticks
+ */
+void metrics_resource_released(int resource_id, unsigned int now, unsigned int hold);
+
+/**
+ * metrics_print_resource - print the contention of @resource_id in a line
+ */
+void metrics_print_resource(int resource_id, unsigned int now);
+
+/**
+ * metrics_print_resources - print the contention of the resources ever used
+ */
+void metrics_print_resources(unsigned int now);
+
+#endif
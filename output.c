@@ -0,0 +1,132 @@
+/**********************************************************************
+ * Copyright (c) 2019-2021
+ *  Sang-Hoon Kim <sanghoonkim@ajou.ac.kr>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTIABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ **********************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <errno.h>
+#include <signal.h>
+#include <unistd.h>
+
+#include "output.h"
+
+#define OUTPUT_BUFFER_SIZE	(1 << 20)
+
+static char __buffer[OUTPUT_BUFFER_SIZE];
+static size_t __buffered = 0;
+
+/* A run of spaces to copy the indentation from */
+static char __spaces[1024];
+
+static void __write_all(const char *str, size_t len)
+{
+	while (len) {
+		ssize_t written = write(STDERR_FILENO, str, len);
+		if (written < 0) {
+			if (errno == EINTR) continue;
+			return;
+		}
+		str += written;
+		len -= written;
+	}
+}
+
+void output_flush(void)
+{
+	__write_all(__buffer, __buffered);
+	__buffered = 0;
+}
+
+/**
+ * Do not lose the trace leading to a crash. write() is safe to call here
+ */
+static void __output_crash_handler(int sig)
+{
+	output_flush();
+
+	signal(sig, SIG_DFL);
+	raise(sig);
+}
+
+void output_init(void)
+{
+	struct sigaction sa = {
+		.sa_handler = __output_crash_handler,
+	};
+
+	memset(__spaces, ' ', sizeof(__spaces));
+
+	sigemptyset(&sa.sa_mask);
+	sigaction(SIGABRT, &sa, NULL);
+	sigaction(SIGSEGV, &sa, NULL);
+
+	atexit(output_flush);
+}
+
+void output_write(const char *str, size_t len)
+{
+	if (__buffered + len > OUTPUT_BUFFER_SIZE) {
+		output_flush();
+
+		/* Too large to buffer. Write it through */
+		if (len > OUTPUT_BUFFER_SIZE) {
+			__write_all(str, len);
+			return;
+		}
+	}
+
+	memcpy(__buffer + __buffered, str, len);
+	__buffered += len;
+}
+
+void output_indent(size_t nr_spaces)
+{
+	while (nr_spaces) {
+		size_t len = nr_spaces < sizeof(__spaces) ? nr_spaces : sizeof(__spaces);
+
+		output_write(__spaces, len);
+		nr_spaces -= len;
+	}
+}
+
+void output_printf(const char *fmt, ...)
+{
+	size_t room = OUTPUT_BUFFER_SIZE - __buffered;
+	va_list args;
+	int len;
+
+	va_start(args, fmt);
+	len = vsnprintf(__buffer + __buffered, room, fmt, args);
+	va_end(args);
+
+	if (len < 0) return;
+
+	if (len < room) {
+		__buffered += len;
+		return;
+	}
+
+	/* Did not fit. Make room for it and try again */
+	output_flush();
+
+	va_start(args, fmt);
+	if (len < OUTPUT_BUFFER_SIZE) {
+		__buffered = vsnprintf(__buffer, OUTPUT_BUFFER_SIZE, fmt, args);
+	} else {
+		vdprintf(STDERR_FILENO, fmt, args);
+	}
+	va_end(args);
+}
@@ -0,0 +1,47 @@
+/**********************************************************************
+ * Copyright (c) 2019-2021
+ *  Sang-Hoon Kim <sanghoonkim@ajou.ac.kr>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTIABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ **********************************************************************/
+
+#ifndef __OUTPUT_H__
+#define __OUTPUT_H__
+
+#include <stddef.h>
+
+/**
+ * Buffered output for the simulation trace on stderr.
+ *
+ * The trace is accumulated in a large buffer and written to stderr in blocks.
+ * The buffer is flushed when it gets full, on exit, and when the program
+ * crashes with SIGABRT (e.g., an assertion failure) or SIGSEGV. Call
+ * output_flush() before writing to stderr in other ways to keep the order.
+ */
+void output_init(void);
+void output_flush(void);
+
+/**
+ * output_write - put @len bytes of @str into the buffer
+ */
+void output_write(const char *str, size_t len);
+
+/**
+ * output_indent - put @nr_spaces spaces into the buffer
+ */
+void output_indent(size_t nr_spaces);
+
+/**
+ * output_printf - printf() into the buffer
+ */
+void output_printf(const char *fmt, ...) __attribute__((format(printf, 1, 2)));
+
+#endif
@@ -18,34 +18,39 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <assert.h>
+#include <limits.h>
 
 #include "types.h"
 #include "list_head.h"
+#include "heap.h"
+#include "pool.h"
 
 /**
  * The process which is currently running
  */
 #include "process.h"
-extern struct process *current;
+#include "prio_array.h"
+#include "proc_table.h"
+extern __thread struct process *current;
 
 
 /**
  * List head to hold the processes ready to run
  */
-extern struct list_head readyqueue;
+extern __thread struct list_head readyqueue;
 
 
 /**
  * Resources in the system.
  */
 #include "resource.h"
-extern struct resource resources[NR_RESOURCES];
+extern __thread struct resource *resources;
 
 
 /**
  * Monotonically increasing ticks
  */
-extern unsigned int ticks;
+extern __thread unsigned int ticks;
 
 
 /**
@@ -54,6 +59,14 @@ extern unsigned int ticks;
 extern bool quiet;
 
 
+/**
+ * The CPU that the framework is calling back for. @current and @readyqueue
+ * are the ones of this CPU. Schedulers keeping their own ready queues keep
+ * one for each CPU and use the one of @this_cpu.
+ */
+extern __thread unsigned int this_cpu;
+
+
 /***********************************************************************
  * Default FCFS resource acquision function
  *
@@ -133,7 +146,7 @@ void fcfs_release(int resource_id)
 		 * Put the waiter process into ready queue. The framework will
 		 * do the rest.
 		 */
-		list_add_tail(&waiter->list, &readyqueue);
+		enqueue_process(waiter);
 	}
 }
 
@@ -200,69 +213,112 @@ pick_next:
 	return next;
 }
 
-struct scheduler fifo_scheduler = {
+/**
+ * FIFO never preempts the current
+ */
+static unsigned int fcfs_timeslice(void)
+{
+	return UINT_MAX;
+}
+
+const struct scheduler fifo_scheduler = {
 	.name = "FIFO",
 	.acquire = fcfs_acquire,
 	.release = fcfs_release,
 	.initialize = fifo_initialize,
 	.finalize = fifo_finalize,
 	.schedule = fifo_schedule,
+	.timeslice = fcfs_timeslice,
 };
 
 
 /***********************************************************************
  * SJF scheduler
  ***********************************************************************/
-static struct process *sjf_schedule(void)
-{
-    struct list_head* ptr;
-    struct process* prc = NULL;
 
-    int min=1000; //lifespan의 min 찾기 위해
-    int cnt=0;
-	
-    if (!current || current->status == PROCESS_WAIT) {
-		goto pick_next;
+/**
+ * Ready queue of SJF and SRTF, ordered by the remaining time of processes
+ * (@lifespan - @age). Processes with the same remaining time come out in
+ * the order they became ready
+ */
+static __thread struct heap sjf_rqs[MAX_CPUS];
+#define sjf_rq	(sjf_rqs[this_cpu])
+
+static int sjf_initialize(void)
+{
+	for (int i = 0; i < MAX_CPUS; i++) {
+		heap_init(sjf_rqs + i);
 	}
-    /* The current process has remaining lifetime. Schedule it again */
-	if (current->age < current->lifespan) {
-		return current;
+	return 0;
+}
+
+static void sjf_finalize(void)
+{
+	for (int i = 0; i < MAX_CPUS; i++) {
+		heap_destroy(sjf_rqs + i);
 	}
+}
 
-pick_next:
+static unsigned int sjf_nr_ready(void)
+{
+	return sjf_rq.nr;
+}
+
+static void sjf_enqueue(struct process *p)
+{
+	heap_push(&sjf_rq, &p->node, p->lifespan - p->age);
+}
+
+static void sjf_dequeue(struct process *p)
+{
+	heap_remove(&sjf_rq, &p->node);
+}
 
-    list_for_each(ptr, &readyqueue){
-            prc = list_entry(ptr, struct process, list);
-            cnt++;
-        }
+/**
+ * Take out the process with the shortest remaining time. NULL if no process
+ * is ready
+ */
+static struct process *sjf_pick_next(void)
+{
+	struct heap_node *node = heap_pop(&sjf_rq);
 
-    if(cnt!=0){
-        list_for_each(ptr, &readyqueue){
-            prc = list_entry(ptr, struct process, list);
-            if (min > prc->lifespan)
-                min = prc->lifespan;
-        }
+	return node ? container_of(node, struct process, node) : NULL;
+}
 
-        list_for_each(ptr, &readyqueue){
-            prc = list_entry(ptr, struct process, list);
-            if (min == prc->lifespan){
-                list_del_init(&prc->list);
-                return prc;
-            }
-        }
+/**
+ * Idle CPUs take the shortest job from busy ones
+ */
+static struct process *sjf_steal(void)
+{
+	return sjf_pick_next();
+}
 
-    }
+static struct process *sjf_schedule(void)
+{
+	if (!current || current->status == PROCESS_WAIT) {
+		goto pick_next;
+	}
+	/* The current process has remaining lifetime. Schedule it again */
+	if (current->age < current->lifespan) {
+		return current;
+	}
 
-    return prc;
+pick_next:
+	return sjf_pick_next();
 }
 
-struct scheduler sjf_scheduler = {
+const struct scheduler sjf_scheduler = {
 	.name = "Shortest-Job First",
 	.acquire = fcfs_acquire, /* Use the default FCFS acquire() */
 	.release = fcfs_release, /* Use the default FCFS release() */
-	.schedule = sjf_schedule,		 /* TODO: Assign sjf_schedule()
-								to this function pointer to activate
-								SJF in the system */
+	.initialize = sjf_initialize,
+	.finalize = sjf_finalize,
+	.schedule = sjf_schedule,
+	.timeslice = fcfs_timeslice, /* Non-preemptive as FIFO */
+	.enqueue = sjf_enqueue,
+	.dequeue = sjf_dequeue,
+	.nr_ready = sjf_nr_ready,
+	.steal = sjf_steal,
 };
 
 
@@ -271,472 +327,1040 @@ struct scheduler sjf_scheduler = {
  ***********************************************************************/
 static struct process *srtf_schedule(void)
 {
-    // if(sched->forked){ //새로운 프로세스 생성됐다면..?
-    //     sched->forked(p);
-    // }
-
-    struct list_head* ptr;
-    struct process* prc = NULL;
-
-	int min=1000; //lifespan의 min 찾기 위해
-    int cnt=0;
-	int cur_remain=0;
+	struct heap_node *shortest;
 
-	list_for_each(ptr, &readyqueue){
-        prc = list_entry(ptr, struct process, list);
-        cnt++;
-    }
-
-    if(cnt!=0){
-        list_for_each(ptr, &readyqueue){
-            prc = list_entry(ptr, struct process, list);
-            if (min > prc->lifespan)
-            	min = prc->lifespan;
-        }
-	}
-
-    if (!current || current->status == PROCESS_WAIT) { //이때는 sjf랑 똑같이?
+	if (!current || current->status == PROCESS_WAIT) {
 		goto pick_next;
 	}
-    /* The current process has remaining lifetime. Schedule it again */
-	if (current->age < current->lifespan) { //이 시점에 다른 프로세스의 lifespan들과 비교 -> preemptive 가능
-		
-		cur_remain = current->lifespan - current->age;
-	
-		if(min < cur_remain){
-				list_for_each(ptr, &readyqueue){
-            		prc = list_entry(ptr, struct process, list);
-            		if (min == prc->lifespan){
-                		list_del_init(&prc->list);
-						list_add(&current->list, &readyqueue);
-                		return prc;
-            		}
-        		}
-			}
-			else{
-				return current;
-			}
 
+	if (current->age < current->lifespan) {
+		/**
+		 * Preempt the current if a ready process has less work remaining.
+		 * The key of the heap is the remaining time
+		 */
+		shortest = heap_peek(&sjf_rq);
+		if (shortest && shortest->key < current->lifespan - current->age) {
+			sjf_enqueue(current);
+			goto pick_next;
+		}
+		return current;
 	}
 
 pick_next:
-	list_for_each(ptr, &readyqueue){
-            prc = list_entry(ptr, struct process, list);
-            cnt++;
-        }
-    if(cnt!=0){
-        list_for_each(ptr, &readyqueue){
-            prc = list_entry(ptr, struct process, list);
-            if (min > prc->lifespan)
-            	min = prc->lifespan;
-        }
-        	list_for_each(ptr, &readyqueue){
-            	prc = list_entry(ptr, struct process, list);
-            	if (min == prc->lifespan){
-                	list_del_init(&prc->list);
-                	return prc;
-            	}
-        	}
-    }
-	return prc;
-}
-
-struct scheduler srtf_scheduler = {
+	return sjf_pick_next();
+}
+
+static unsigned int srtf_timeslice(void)
+{
+	struct heap_node *shortest = heap_peek(&sjf_rq);
+
+	/**
+	 * The remaining time of the current only gets shorter while it runs,
+	 * so it keeps running unless it should be preempted right away
+	 */
+	if (shortest && shortest->key < current->lifespan - current->age) {
+		return 0;
+	}
+	return UINT_MAX;
+}
+
+const struct scheduler srtf_scheduler = {
 	.name = "Shortest Remaining Time First",
 	.acquire = fcfs_acquire, /* Use the default FCFS acquire() */
 	.release = fcfs_release, /* Use the default FCFS release() */
-	/* You need to check the newly created processes to implement SRTF.
-	 * Use @forked() callback to mark newly created processes */
-	/* Obviously, you should implement srtf_schedule() and attach it here */
-    .schedule = srtf_schedule,
+	/**
+	 * Newly forked processes and woken-up waiters enter @sjf_rq through
+	 * enqueue(). So schedule() only compares the shortest one with the current
+	 */
+	.initialize = sjf_initialize,
+	.finalize = sjf_finalize,
+	.schedule = srtf_schedule,
+	.timeslice = srtf_timeslice,
+	.enqueue = sjf_enqueue,
+	.dequeue = sjf_dequeue,
+	.nr_ready = sjf_nr_ready,
+	.steal = sjf_steal,
 };
 
 
 /***********************************************************************
  * Round-robin scheduler
  ***********************************************************************/
-int ticks_cnt=-1; 
+/**
+ * # of ticks a process runs before yielding the processor to the next (-Q)
+ */
+__thread unsigned int rr_quantum = 1;
 
-static struct process *rr_schedule(void)
+/**
+ * # of ticks @p has run in its time slice. A process running alone keeps
+ * going with new slices, so this gives the same answer however often the
+ * framework calls schedule() in the meantime
+ */
+static unsigned int rr_slice_used(struct process *p)
+{
+	unsigned int used = p->age - p->slice_start;
+
+	if (used > rr_quantum) {
+		p->slice_start += (used - 1) / rr_quantum * rr_quantum;
+		used = p->age - p->slice_start;
+	}
+	return used;
+}
+
+static struct process *rr_pick_next(void)
 {
-    struct process* prc = NULL;
-	ticks_cnt++;
+	struct process *next = NULL;
+
+	if (!list_empty(&readyqueue)) {
+		next = list_first_entry(&readyqueue, struct process, list);
+		list_del_init(&next->list);
+		next->slice_start = next->age;
+	}
+	return next;
+}
 
-	if (!current || current->status == PROCESS_WAIT) { 
+static struct process *rr_schedule(void)
+{
+	if (!current || current->status == PROCESS_WAIT) {
 		goto pick_next;
 	}
-	if (current->age < current->lifespan) { //current가 돌고 있어도 타임퀀텀(=1) 지나면 preemption
-	
-		if(ticks == ticks_cnt){ //preemption
-			if (!list_empty(&readyqueue)) {
-				prc = list_first_entry(&readyqueue, struct process, list);
-				list_del_init(&prc->list);
-
-				list_add_tail(&current->list, &readyqueue);
-				return prc;
-			}		
-		}		
+
+	if (current->age < current->lifespan) {
+		/* Preempt the current when its time slice is over */
+		if (rr_slice_used(current) >= rr_quantum && !list_empty(&readyqueue)) {
+			list_add_tail(&current->list, &readyqueue);
+			goto pick_next;
+		}
 		return current;
 	}
 
 pick_next:
-	if (!list_empty(&readyqueue)) {
-		prc = list_first_entry(&readyqueue, struct process, list);
-		list_del_init(&prc->list);
-	}
-	return prc;
+	return rr_pick_next();
+}
+
+/**
+ * The current runs to the end of its time slice, or forever if alone
+ */
+static unsigned int rr_timeslice(void)
+{
+	unsigned int used;
+
+	if (list_empty(&readyqueue)) return UINT_MAX;
+
+	used = rr_slice_used(current);
+	return used < rr_quantum ? rr_quantum - used : 0;
 }
 
-struct scheduler rr_scheduler = {
+const struct scheduler rr_scheduler = {
 	.name = "Round-Robin",
 	.acquire = fcfs_acquire, /* Use the default FCFS acquire() */
 	.release = fcfs_release, /* Use the default FCFS release() */
 	/* Obviously, you should implement rr_schedule() and attach it here */
 	.schedule = rr_schedule,
+	.timeslice = rr_timeslice,
 };
 
 
 /***********************************************************************
- * Priority scheduler
+ * Multi-level feedback queue scheduler
  ***********************************************************************/
-bool prio_acquire(int resource_id){
-	//true on successful acquision
-	//false if the resource is already held by others or unavailable
-
-	struct resource *r = resources + resource_id;
+/**
+ * Processes start at level 0, the top level, and go down one level whenever
+ * they use up the quantum of the level, which doubles at each level from
+ * @rr_quantum. Processes blocking before that stay at the level. The
+ * scheduler runs processes at the top-most level in the round-robin way, and
+ * moves all processes back to the top level every MLFQ_BOOST_INTERVAL ticks
+ * not to starve the processes at the bottom levels.
+ *
+ * Every process gets boosted at once, including the ones waiting for
+ * resources; instead of visiting them, a process whose @boosted_at is not the
+ * current boost period is regarded to be at the top level.
+ */
+#define MLFQ_LEVELS			4
+#define MLFQ_BOOST_INTERVAL	32
 
-	if (!r->owner) {
-		r->owner = current;
-		current->status = PROCESS_WAIT; 
-		list_add_tail(&current->list, &readyqueue);
-		return true;
-	}
-	current->status = PROCESS_WAIT;
-    list_add_tail(&current->list, &r->waitqueue);
+struct mlfq_rq {
+	unsigned int nr_ready;
+	unsigned int boosted_at;	/* The boost period the levels are in */
+	struct list_head level[MLFQ_LEVELS];
+};
 
-	return false;
-	
+static __thread struct mlfq_rq mlfq_rqs[MAX_CPUS];
+#define mlfq_rq	(mlfq_rqs[this_cpu])
 
+static inline unsigned int mlfq_period(void)
+{
+	return ticks / MLFQ_BOOST_INTERVAL;
 }
 
-void prio_release(int resource_id){
-
-	int max=0;
-	int cnt=0; 
-	struct list_head* ptr;
-	struct process* prc = NULL;
-
-	struct process* waiter = NULL;
-	struct resource *r = resources + resource_id;
-
-	assert(r->owner == current);
-	r->owner = NULL;
-
-	list_for_each(ptr, &r->waitqueue){
-        prc = list_entry(ptr, struct process, list);
-		cnt++;
-    }
-
-	//놓을 때는 어떻게 처리할건지?
-	if (!list_empty(&r->waitqueue)) {
-		list_for_each(ptr, &r->waitqueue){
-        	prc = list_entry(ptr, struct process, list);
-			if(max < prc->prio)
-				max = prc->prio;
-    	}
-
-		//wake up high priority waiter! 
-		list_for_each(ptr, &r->waitqueue){
-            prc = list_entry(ptr, struct process, list);
-			if(prc->prio==max){
-				waiter = prc;
-				goto next;
-			}
-        }
+static inline unsigned int mlfq_quantum(unsigned int level)
+{
+	return rr_quantum << level;
+}
 
-		next:
-		assert(waiter->status == PROCESS_WAIT);
-		list_del_init(&waiter->list);
-		waiter->status = PROCESS_READY;
-		list_add_tail(&waiter->list, &readyqueue);
+/**
+ * The level of @p, applying the boost that @p has missed so far
+ */
+static unsigned int mlfq_level(struct process *p)
+{
+	if (p->boosted_at != mlfq_period()) {
+		p->boosted_at = mlfq_period();
+		p->level = 0;
+		p->slice_start = p->age;
 	}
-
+	return p->level;
 }
 
- static struct process *prio_schedule(void)
- {
-	 //숫자가 클수록 priority 높은 것
-	struct list_head* ptr;
-    struct process* prc = NULL;
+/**
+ * Move the processes in the ready queue to the top level if a boost is due
+ */
+static void mlfq_boost(void)
+{
+	if (mlfq_rq.boosted_at == mlfq_period()) return;
 
-    int max=0; //prio의 max 찾기 위해
-    int cnt=0;
-	
-    if (!current || current->status == PROCESS_WAIT) {
-		goto pick_next;
+	/* Keep them in the order of the levels */
+	for (int i = 1; i < MLFQ_LEVELS; i++) {
+		list_splice_tail_init(mlfq_rq.level + i, mlfq_rq.level);
 	}
-	if (current->age < current->lifespan) {
-		return current;
+	mlfq_rq.boosted_at = mlfq_period();
+}
+
+static int mlfq_initialize(void)
+{
+	for (int cpu = 0; cpu < MAX_CPUS; cpu++) {
+		mlfq_rqs[cpu].nr_ready = 0;
+		mlfq_rqs[cpu].boosted_at = 0;
+		for (int i = 0; i < MLFQ_LEVELS; i++) {
+			INIT_LIST_HEAD(mlfq_rqs[cpu].level + i);
+		}
 	}
+	return 0;
+}
 
-pick_next:
+static void mlfq_enqueue(struct process *p)
+{
+	mlfq_boost();
+	list_add_tail(&p->list, mlfq_rq.level + mlfq_level(p));
+	mlfq_rq.nr_ready++;
+}
 
-    list_for_each(ptr, &readyqueue){
-            prc = list_entry(ptr, struct process, list);
-            cnt++;
-        }
+static void mlfq_dequeue(struct process *p)
+{
+	list_del_init(&p->list);
+	mlfq_rq.nr_ready--;
+}
 
-    if(cnt!=0){
+/**
+ * Put back @p as it was in the ready queue. Unlike mlfq_enqueue(), leave the
+ * boost @p has missed to be applied when it is picked
+ */
+static void mlfq_refill(struct process *p)
+{
+	mlfq_boost();
+	list_add_tail(&p->list, mlfq_rq.level +
+			(p->boosted_at == mlfq_period() ? p->level : 0));
+	mlfq_rq.nr_ready++;
+}
 
-		 list_for_each(ptr, &readyqueue){
-            prc = list_entry(ptr, struct process, list);
-            if (max < prc->prio)
-                max = prc->prio;
-        }
+static unsigned int mlfq_nr_ready(void)
+{
+	return mlfq_rq.nr_ready;
+}
 
-        list_for_each(ptr, &readyqueue){
-            prc = list_entry(ptr, struct process, list);
-            if (max == prc->prio){
-                list_del_init(&prc->list);
-                return prc;
-            }
-        }
+/**
+ * The top-most level with ready processes. MLFQ_LEVELS if none is ready
+ */
+static unsigned int mlfq_highest(void)
+{
+	unsigned int level = 0;
 
+	while (level < MLFQ_LEVELS && list_empty(mlfq_rq.level + level)) {
+		level++;
 	}
+	return level;
+}
 
-	return prc;
+static struct process *mlfq_pick_next(void)
+{
+	unsigned int level;
+	struct process *next;
 
- }
+	mlfq_boost();
 
-struct scheduler prio_scheduler = {
-	.name = "Priority",
-	/**
-	 * Implement your own acqure/release function to make priority
-	 * scheduler correct.
-	 */
-	.acquire = prio_acquire,
-	.release = prio_release,
-	/* Implement your own prio_schedule() and attach it here */
-	.schedule = prio_schedule,
-};
+	level = mlfq_highest();
+	if (level == MLFQ_LEVELS) return NULL;
 
+	next = list_first_entry(mlfq_rq.level + level, struct process, list);
+	mlfq_dequeue(next);
+	return next;
+}
 
-/***********************************************************************
- * Priority scheduler with aging
- ***********************************************************************/
-static struct process *pa_schedule(void){
-	 //숫자가 클수록 priority 높은 것
-	struct list_head* ptr;
-    struct process* prc = NULL;
-	struct process* next = NULL;
-
-    int max=0; //prio의 max 찾기 위해
-    int cnt=0;
-	int flag=0;
-	int preemption_flag=0;
-	
-    list_for_each(ptr, &readyqueue){
-            prc = list_entry(ptr, struct process, list);
-            cnt++;
-        }
-	
-    if (!current || current->status == PROCESS_WAIT) {
+static struct process *mlfq_schedule(void)
+{
+	unsigned int level;
+
+	if (!current || current->status == PROCESS_WAIT) {
 		goto pick_next;
 	}
+
 	if (current->age < current->lifespan) {
-		
-		if(cnt!=0){
-			
-            list_for_each(ptr, &readyqueue){
-                prc = list_entry(ptr, struct process, list);
-                if (max < prc->prio)
-                    max = prc->prio;
-            }
-            
-            if(current->prio <= max){ //preemption!
-                list_add_tail(&current->list, &readyqueue);
-
-                preemption_flag=1;
-                goto pick_next;
-                
-            }
-
-            list_for_each(ptr, &readyqueue){
-                prc = list_entry(ptr, struct process, list);
-                if(prc->prio < MAX_PRIO)
-                    prc->prio++;              
-            }
-        }
-		current->prio = current->prio_orig;
-		
+		mlfq_boost();
+		level = mlfq_level(current);
+
+		/* Used up the quantum. Go down a level, and let others run first */
+		if (current->age - current->slice_start >= mlfq_quantum(level)) {
+			if (level < MLFQ_LEVELS - 1) current->level++;
+			current->slice_start = current->age;
+			mlfq_enqueue(current);
+			goto pick_next;
+		}
+
+		/* Preempt for a process at a higher level */
+		if (mlfq_highest() < level) {
+			mlfq_enqueue(current);
+			goto pick_next;
+		}
 		return current;
 	}
 
 pick_next:
+	return mlfq_pick_next();
+}
 
-    if(cnt!=0){
-
-		 list_for_each(ptr, &readyqueue){
-            prc = list_entry(ptr, struct process, list);
-            if (max < prc->prio)
-                max = prc->prio;
-        }
-
-        list_for_each(ptr, &readyqueue){
-            prc = list_entry(ptr, struct process, list);
-            if (max == prc->prio && flag==0){
-				flag=1;
-				next=prc;
-            }
-			else if(prc->prio < MAX_PRIO){
-				prc->prio++;
-			}
-        }
+/**
+ * The current keeps running until it uses up the quantum or a boost comes
+ */
+static unsigned int mlfq_timeslice(void)
+{
+	unsigned int level, used;
+	unsigned int to_boost = MLFQ_BOOST_INTERVAL - ticks % MLFQ_BOOST_INTERVAL;
 
-    list_del_init(&next->list);
-    next->prio = next->prio_orig;
+	mlfq_boost();
+	level = mlfq_level(current);
+	used = current->age - current->slice_start;
 
+	/* Preempted by a process woken up at a higher level, or used up */
+	if (mlfq_highest() < level || used >= mlfq_quantum(level) ||
+			to_boost == MLFQ_BOOST_INTERVAL) {
+		return 0;
 	}
-	return next;
- }
+	if (mlfq_quantum(level) - used < to_boost) {
+		return mlfq_quantum(level) - used;
+	}
+	return to_boost;
+}
 
-struct scheduler pa_scheduler = {
-	.name = "Priority + aging",
-	/**
-	 * Implement your own acqure/release function to make priority
-	 * scheduler correct.
-	 */
-	/* Implement your own prio_schedule() and attach it here */
-	.acquire = prio_acquire,
-	.release = prio_release,
-	.schedule = pa_schedule,
+const struct scheduler mlfq_scheduler = {
+	.name = "Multi-level Feedback Queue",
+	.acquire = fcfs_acquire,
+	.release = fcfs_release,
+	.initialize = mlfq_initialize,
+	.schedule = mlfq_schedule,
+	.timeslice = mlfq_timeslice,
+	.enqueue = mlfq_enqueue,
+	.dequeue = mlfq_dequeue,
+	.nr_ready = mlfq_nr_ready,
+	.steal = mlfq_pick_next,
+	.refill = mlfq_refill,
 };
 
 
-
 /***********************************************************************
- * Priority scheduler with priority ceiling protocol
+ * Priority scheduler
  ***********************************************************************/
-bool pcp_acquire(int resource_id){
-    struct resource *r = resources + resource_id;
-
-	if (!r->owner) {
-		r->owner = current;
 
-        r->owner->prio=MAX_PRIO; 
+/**
+ * Ready queue of the priority-based schedulers (prio, pcp, and pip)
+ */
+static __thread struct prio_array prio_rqs[MAX_CPUS];
+#define prio_rq	(prio_rqs[this_cpu])
 
-		current->status = PROCESS_WAIT; 
-		list_add_tail(&current->list, &readyqueue);
-		return true;
+static int prio_initialize(void)
+{
+	for (int i = 0; i < MAX_CPUS; i++) {
+		prio_array_init(prio_rqs + i);
 	}
-	current->status = PROCESS_WAIT;
-    list_add_tail(&current->list, &r->waitqueue);
-
-	return false;
+	return 0;
 }
-void pcp_release(int resource_id){
-    int max=0;
-    int cnt=0;
-	struct list_head* ptr;
-	struct process* prc = NULL;
 
-	struct process* waiter = NULL;
-	struct resource *r = resources + resource_id;
+static unsigned int prio_nr_ready(void)
+{
+	return prio_rq.nr_active;
+}
 
-	assert(r->owner == current);
+static void prio_enqueue(struct process *p)
+{
+	prio_array_enqueue(&prio_rq, p);
+}
 
-    r->owner->prio = r->owner->prio_orig; 
+static void prio_dequeue(struct process *p)
+{
+	prio_array_dequeue(&prio_rq, p);
+}
 
-	r->owner = NULL;
+/**
+ * Idle CPUs take the process with the highest priority from busy ones
+ */
+static struct process *prio_steal(void)
+{
+	struct process *p = prio_array_first(&prio_rq);
 
-	list_for_each(ptr, &r->waitqueue){
-        prc = list_entry(ptr, struct process, list);
-		cnt++;
-    }
+	if (p) prio_dequeue(p);
+	return p;
+}
 
-	//놓을 때는 어떻게 처리할건지?
-	if (!list_empty(&r->waitqueue)) {
-	
-		list_for_each(ptr, &r->waitqueue){
-        	prc = list_entry(ptr, struct process, list);
-			if(max < prc->prio)
-				max = prc->prio;
-    	}
-		
-		list_for_each(ptr, &r->waitqueue){
-            prc = list_entry(ptr, struct process, list);
-			if(prc->prio==max){
-				waiter = prc;
-				goto next;
-			}
-        }
+/**
+ * Change the priority of @p which is in @prio_rq, moving it to the tail of
+ * the new priority level
+ */
+static void prio_requeue(struct process *p, unsigned int prio)
+{
+	/* @p may be in the ready queue of another CPU */
+	dequeue_process(p);
+	p->prio = prio;
+	enqueue_process(p);
+}
 
-		next:
-		assert(waiter->status == PROCESS_WAIT);
-		list_del_init(&waiter->list);
-		waiter->status = PROCESS_READY;
-		list_add_tail(&waiter->list, &readyqueue);
-	}
+/**
+ * Waiters of a resource are ordered by their priority in @r->waiters.
+ * The higher the priority is, the smaller the key is. Priorities above
+ * MAX_PRIO wait at the level of MAX_PRIO as in the ready queue
+ */
+static inline unsigned long prio_wait_key(struct process *p)
+{
+	return MAX_PRIO - prio_array_level(p);
+}
 
+/**
+ * Make @current wait for @r
+ */
+static void prio_wait(struct resource *r)
+{
+	current->status = PROCESS_WAIT;
+	current->blocked_on = r;
+	heap_push(&r->waiters, &current->node, prio_wait_key(current));
 }
 
-static struct process *pcp_schedule(void){
-    struct list_head* ptr;
-    struct process* prc = NULL;
-	struct process* next = NULL;
+/**
+ * Wake up the waiter of @r with the highest priority. The one came first
+ * among the waiters with the same priority
+ */
+static void prio_wake_up(struct resource *r)
+{
+	struct heap_node *node = heap_pop(&r->waiters);
+	struct process *waiter;
 
-    int max=0; //prio의 max 찾기 위해
-    int cnt=0;
-	int flag=0;
-	int preemption_flag=0;
-	
-    list_for_each(ptr, &readyqueue){
-            prc = list_entry(ptr, struct process, list);
-            cnt++;
-        }
-	
-    if (!current || current->status == PROCESS_WAIT) {
-		goto pick_next;
+	if (!node) return;
+
+	waiter = container_of(node, struct process, node);
+	assert(waiter->status == PROCESS_WAIT);
+
+	waiter->blocked_on = NULL;
+	waiter->status = PROCESS_READY;
+	enqueue_process(waiter);
+}
+
+bool prio_acquire(int resource_id){
+	//true on successful acquision
+	//false if the resource is already held by others or unavailable
+
+	struct resource *r = resources + resource_id;
+
+	if (!r->owner) {
+		r->owner = current;
+		/**
+		 * @current may take more than one resource in a tick, but yields
+		 * only once. And it exits right after this tick if this is its
+		 * last one
+		 */
+		if (current->status == PROCESS_RUNNING) {
+			current->status = PROCESS_WAIT;
+			if (current->age + 1 < current->lifespan) {
+				enqueue_process(current);
+			}
+		}
+		return true;
+	}
+
+	/* Took another resource in this tick and yielded. Undo it to wait */
+	if (current->status == PROCESS_WAIT &&
+			current->age + 1 < current->lifespan) {
+		dequeue_process(current);
+	}
+	prio_wait(r);
+	return false;
+}
+
+void prio_release(int resource_id)
+{
+	struct resource *r = resources + resource_id;
+
+	assert(r->owner == current);
+	r->owner = NULL;
+
+	prio_wake_up(r);
+}
+
+/**
+ * Preemptive priority schedulers keep the current until a process with the
+ * same or higher priority gets ready, which can happen only on an event
+ */
+static unsigned int prio_timeslice(void)
+{
+	if (!prio_array_empty(&prio_rq) &&
+			current->prio <= prio_array_highest(&prio_rq)) {
+		return 0;
+	}
+	return UINT_MAX;
+}
+
+static struct process *prio_schedule(void)
+{
+	struct process *next;
+
+	if (!current || current->status == PROCESS_WAIT) {
+		goto pick_next;
+	}
+
+	/* Keep running the current until it completes */
+	if (current->age < current->lifespan) {
+		return current;
+	}
+
+pick_next:
+	/* The first process among the ones with the highest priority */
+	next = prio_array_first(&prio_rq);
+	if (next) {
+		prio_dequeue(next);
+	}
+	return next;
+}
+
+const struct scheduler prio_scheduler = {
+	.name = "Priority",
+	/**
+	 * Implement your own acqure/release function to make priority
+	 * scheduler correct.
+	 */
+	.acquire = prio_acquire,
+	.release = prio_release,
+	/* Implement your own prio_schedule() and attach it here */
+	.initialize = prio_initialize,
+	.schedule = prio_schedule,
+	.timeslice = fcfs_timeslice, /* Non-preemptive as FIFO */
+	.enqueue = prio_enqueue,
+	.dequeue = prio_dequeue,
+	.nr_ready = prio_nr_ready,
+	.steal = prio_steal,
+};
+
+
+/***********************************************************************
+ * Priority scheduler with aging
+ ***********************************************************************/
+
+/**
+ * Ready queue for aging. Every scheduling round, all processes in the ready
+ * queue age by one, and their priorities go up by one until MAX_PRIO. Instead
+ * of boosting each of them, a process keeps the priority it had when it was
+ * enqueued in @prio along with @enqueued_at, and its effective priority is
+ *
+ *   min(MAX_PRIO, prio + (pa_rq.epoch - enqueued_at))
+ *
+ * Processes below MAX_PRIO are in @level. As all of them age at the same
+ * pace, their order never changes and @level works as a ring rotated by
+ * @epoch; logical priority level @n is in @level[(n - epoch) % MAX_PRIO].
+ * When a level reaches MAX_PRIO, its processes move to @saturated. All
+ * processes there have the same priority, so they are ordered by the time
+ * they were enqueued (kept in @node.key) to have the same order as in the
+ * original readyqueue.
+ */
+struct aging_rq {
+	unsigned int epoch;		/* # of aging steps so far */
+	unsigned int rounds;	/* # of scheduling rounds since the last step */
+	unsigned long seq;		/* Enqueue order */
+	unsigned int nr_active;
+	unsigned long long bitmap;
+							/* Bit n is set if @level[n] is not empty */
+	struct list_head level[MAX_PRIO];
+	struct heap saturated;
+};
+
+static __thread struct aging_rq pa_rqs[MAX_CPUS];
+#define pa_rq	(pa_rqs[this_cpu])
+
+/**
+ * # of scheduling rounds to boost the priority of waiting processes by one
+ * (-A). The sweep mode runs the simulations with different periods at once
+ */
+__thread unsigned int pa_aging_period = 1;
+
+#if MAX_PRIO > 64
+#error "Aging ready queue keeps its levels in a 64-bit bitmap"
+#endif
+#define PA_LEVEL_MASK	((MAX_PRIO == 64) ? ~0ULL : ((1ULL << MAX_PRIO) - 1))
+
+static inline unsigned int pa_slot(unsigned int prio)
+{
+	return (prio + MAX_PRIO - pa_rq.epoch % MAX_PRIO) % MAX_PRIO;
+}
+
+static inline unsigned int pa_effective_prio(struct process *p)
+{
+	unsigned int prio = p->prio + (pa_rq.epoch - p->enqueued_at);
+
+	return prio < MAX_PRIO ? prio : MAX_PRIO;
+}
+
+static int pa_initialize(void)
+{
+	for (int cpu = 0; cpu < MAX_CPUS; cpu++) {
+		struct aging_rq *rq = pa_rqs + cpu;
+
+		rq->epoch = 0;
+		rq->rounds = 0;
+		rq->seq = 0;
+		rq->nr_active = 0;
+		rq->bitmap = 0;
+		for (int i = 0; i < MAX_PRIO; i++) {
+			INIT_LIST_HEAD(rq->level + i);
+		}
+		heap_init(&rq->saturated);
+	}
+	return 0;
+}
+
+static void pa_finalize(void)
+{
+	for (int cpu = 0; cpu < MAX_CPUS; cpu++) {
+		heap_destroy(&pa_rqs[cpu].saturated);
+	}
+}
+
+static unsigned int pa_nr_ready(void)
+{
+	return pa_rq.nr_active;
+}
+
+static void pa_enqueue(struct process *p)
+{
+	p->enqueued_at = pa_rq.epoch;
+	p->node.key = pa_rq.seq++;
+
+	/* Saturated already, as pa_effective_prio() tells when taking it out */
+	if (p->prio >= MAX_PRIO) {
+		heap_push(&pa_rq.saturated, &p->node, p->node.key);
+	} else {
+		unsigned int slot = pa_slot(p->prio);
+		list_add_tail(&p->list, pa_rq.level + slot);
+		pa_rq.bitmap |= 1ULL << slot;
+	}
+	pa_rq.nr_active++;
+}
+
+/**
+ * Take @p out, and make its @prio the effective one
+ */
+static void pa_dequeue(struct process *p)
+{
+	unsigned int prio = pa_effective_prio(p);
+
+	if (prio == MAX_PRIO) {
+		heap_remove(&pa_rq.saturated, &p->node);
+	} else {
+		unsigned int slot = pa_slot(prio);
+		list_del_init(&p->list);
+		if (list_empty(pa_rq.level + slot)) {
+			pa_rq.bitmap &= ~(1ULL << slot);
+		}
+	}
+	p->prio = prio;
+	pa_rq.nr_active--;
+}
+
+/**
+ * The highest effective priority in the ready queue. -1 if it is empty
+ */
+static int pa_highest(void)
+{
+	unsigned int rot = pa_rq.epoch % MAX_PRIO;
+	unsigned long long levels;
+
+	if (!heap_empty(&pa_rq.saturated)) return MAX_PRIO;
+	if (!pa_rq.bitmap) return -1;
+
+	/* Rotate physical slots to logical levels */
+	levels = rot ? ((pa_rq.bitmap << rot) | (pa_rq.bitmap >> (MAX_PRIO - rot))) &
+			PA_LEVEL_MASK : pa_rq.bitmap;
+
+	return 63 - __builtin_clzll(levels);
+}
+
+/**
+ * Take out the first process among the ones with the highest priority
+ */
+static struct process *pa_pick_next(void)
+{
+	int prio = pa_highest();
+	struct process *next;
+
+	if (prio < 0) return NULL;
+
+	if (prio == MAX_PRIO) {
+		next = container_of(heap_peek(&pa_rq.saturated), struct process, node);
+	} else {
+		next = list_first_entry(pa_rq.level + pa_slot(prio), struct process, list);
+	}
+	pa_dequeue(next);
+	return next;
+}
+
+/**
+ * All processes in the ready queue get older by one scheduling round. Their
+ * priority goes up by one every @pa_aging_period rounds
+ */
+static void pa_age(void)
+{
+	struct list_head *top = pa_rq.level + pa_slot(MAX_PRIO - 1);
+
+	if (++pa_rq.rounds < pa_aging_period) return;
+	pa_rq.rounds = 0;
+
+	/* Processes at MAX_PRIO - 1 reach MAX_PRIO */
+	while (!list_empty(top)) {
+		struct process *p = list_first_entry(top, struct process, list);
+		list_del_init(&p->list);
+		heap_push(&pa_rq.saturated, &p->node, p->node.key);
+	}
+	pa_rq.bitmap &= ~(1ULL << pa_slot(MAX_PRIO - 1));
+
+	/* And the slot becomes the lowest level */
+	pa_rq.epoch++;
+}
+
+/**
+ * Idle CPUs take the process with the highest priority from busy ones. It
+ * keeps the priority it has aged so far
+ */
+static struct process *pa_steal(void)
+{
+	return pa_pick_next();
+}
+
+/**
+ * Take out the process enqueued first regardless of its priority. Putting
+ * them back in this order keeps the order among the ones saturating later
+ */
+static struct process *pa_drain(void)
+{
+	struct heap_node *node = heap_peek(&pa_rq.saturated);
+	struct process *first = node ? container_of(node, struct process, node) : NULL;
+
+	/* Processes in a level are in the enqueue order, too */
+	for (unsigned long long levels = pa_rq.bitmap; levels; levels &= levels - 1) {
+		struct process *p = list_first_entry(pa_rq.level + __builtin_ctzll(levels),
+				struct process, list);
+
+		if (!first || p->node.key < first->node.key) first = p;
+	}
+
+	if (first) pa_dequeue(first);
+	return first;
+}
+
+static unsigned int pa_save(void)
+{
+	return pa_rq.rounds;
+}
+
+static void pa_restore(unsigned int rounds)
+{
+	pa_rq.rounds = rounds;
+}
+
+static struct process *pa_schedule(void)
+{
+	struct process *next;
+
+	if (!current || current->status == PROCESS_WAIT) {
+		goto pick_next;
+	}
+
+	if (current->age < current->lifespan) {
+		/* Preempt if a process with the same or higher priority is ready */
+		if (pa_rq.nr_active && current->prio <= pa_highest()) {
+			pa_enqueue(current);
+			goto pick_next;
+		}
+		current->prio = current->prio_orig;
+
+		pa_age();
+		return current;
+	}
+
+pick_next:
+	next = pa_pick_next();
+	if (next) {
+		next->prio = next->prio_orig;
+	}
+
+	/* Processes left in the ready queue all get aged */
+	pa_age();
+	return next;
+}
+
+const struct scheduler pa_scheduler = {
+	.name = "Priority + aging",
+	/**
+	 * Implement your own acqure/release function to make priority
+	 * scheduler correct.
+	 */
+	/* Implement your own prio_schedule() and attach it here */
+	.acquire = prio_acquire,
+	.release = prio_release,
+	.initialize = pa_initialize,
+	.finalize = pa_finalize,
+	.schedule = pa_schedule,
+	.enqueue = pa_enqueue,
+	.dequeue = pa_dequeue,
+	.nr_ready = pa_nr_ready,
+	.steal = pa_steal,
+	.drain = pa_drain,
+	.save = pa_save,
+	.restore = pa_restore,
+};
+
+
+
+/***********************************************************************
+ * Priority scheduler with aging over the compact process table
+ ***********************************************************************/
+/**
+ * The same policy as pa_scheduler in the straightforward way; each aging
+ * step raises the priority of every ready process, and picking the next
+ * process scans all of them. Both stream through the priorities kept
+ * contiguous in the compact process table (see proc_table.h) instead of
+ * visiting the processes
+ */
+struct pa_scan_rq {
+	struct proc_table table;
+	unsigned int rounds;	/* # of scheduling rounds since the last step */
+};
+
+static __thread struct pa_scan_rq pa_scan_rqs[MAX_CPUS];
+#define pa_scan_rq	(pa_scan_rqs[this_cpu])
+
+static int pa_scan_initialize(void)
+{
+	for (int cpu = 0; cpu < MAX_CPUS; cpu++) {
+		proc_table_init(&pa_scan_rqs[cpu].table);
+		pa_scan_rqs[cpu].rounds = 0;
+	}
+	return 0;
+}
+
+static void pa_scan_finalize(void)
+{
+	for (int cpu = 0; cpu < MAX_CPUS; cpu++) {
+		proc_table_destroy(&pa_scan_rqs[cpu].table);
+	}
+}
+
+static unsigned int pa_scan_nr_ready(void)
+{
+	return pa_scan_rq.table.nr;
+}
+
+static void pa_scan_enqueue(struct process *p)
+{
+	/* Saturated already as in pa_enqueue(). The table ages up to MAX_PRIO */
+	if (p->prio > MAX_PRIO) p->prio = MAX_PRIO;
+
+	proc_table_push(&pa_scan_rq.table, p);
+}
+
+/**
+ * Take @p out with the priority it has aged to
+ */
+static void pa_scan_dequeue(struct process *p)
+{
+	unsigned int pos = proc_table_find(&pa_scan_rq.table, p);
+
+	assert(pos < pa_scan_rq.table.nr);
+	proc_table_remove(&pa_scan_rq.table, pos);
+}
+
+static struct process *pa_scan_pick_next(void)
+{
+	unsigned int pos = proc_table_highest(&pa_scan_rq.table);
+
+	if (pos == pa_scan_rq.table.nr) return NULL;
+	return proc_table_remove(&pa_scan_rq.table, pos);
+}
+
+static void pa_scan_age(void)
+{
+	if (++pa_scan_rq.rounds < pa_aging_period) return;
+	pa_scan_rq.rounds = 0;
+
+	proc_table_age(&pa_scan_rq.table, MAX_PRIO);
+}
+
+/**
+ * Take out the process at the head, so that they are put back in the order
+ */
+static struct process *pa_scan_drain(void)
+{
+	if (!pa_scan_rq.table.nr) return NULL;
+	return proc_table_remove(&pa_scan_rq.table, 0);
+}
+
+static unsigned int pa_scan_save(void)
+{
+	return pa_scan_rq.rounds;
+}
+
+static void pa_scan_restore(unsigned int rounds)
+{
+	pa_scan_rq.rounds = rounds;
+}
+
+static struct process *pa_scan_schedule(void)
+{
+	struct proc_table *table = &pa_scan_rq.table;
+	unsigned int highest = proc_table_highest(table);
+	struct process *next = NULL;
+
+	if (!current || current->status == PROCESS_WAIT) {
+		goto pick_next;
+	}
+
+	if (current->age < current->lifespan) {
+		/**
+		 * Preempt if a process with the same or higher priority is ready.
+		 * @current goes behind it, so @highest still is the one to pick
+		 */
+		if (highest < table->nr && current->prio <= table->prio[highest]) {
+			pa_scan_enqueue(current);
+			goto pick_next;
+		}
+		current->prio = current->prio_orig;
+
+		pa_scan_age();
+		return current;
+	}
+
+pick_next:
+	if (highest < table->nr) {
+		next = proc_table_remove(table, highest);
+		next->prio = next->prio_orig;
+	}
+
+	/* Processes left in the ready queue all get aged */
+	pa_scan_age();
+	return next;
+}
+
+const struct scheduler pa_scan_scheduler = {
+	.name = "Priority + aging (compact table)",
+	.acquire = prio_acquire,
+	.release = prio_release,
+	.initialize = pa_scan_initialize,
+	.finalize = pa_scan_finalize,
+	.schedule = pa_scan_schedule,
+	.enqueue = pa_scan_enqueue,
+	.dequeue = pa_scan_dequeue,
+	.nr_ready = pa_scan_nr_ready,
+	.steal = pa_scan_pick_next,
+	.drain = pa_scan_drain,
+	.save = pa_scan_save,
+	.restore = pa_scan_restore,
+};
+
+
+
+/***********************************************************************
+ * Priority scheduler with priority ceiling protocol
+ ***********************************************************************/
+/**
+ * The priority @p should run at; its own priority or the highest ceiling
+ * among the resources @p owns
+ */
+static unsigned int pcp_ceiling_prio(struct process *p)
+{
+	unsigned int prio = p->prio_orig;
+	struct resource *r;
+
+	list_for_each_entry(r, &p->resources_owned, owned) {
+		if (r->ceiling > prio) prio = r->ceiling;
+	}
+	return prio;
+}
+
+bool pcp_acquire(int resource_id)
+{
+	struct resource *r = resources + resource_id;
+
+	if (!r->owner) {
+		r->owner = current;
+		list_add_tail(&r->owned, &current->resources_owned);
+
+		/**
+		 * Run at the ceiling of the resource until releasing it, so that
+		 * no process that may want it preempts the owner
+		 */
+		if (r->ceiling > current->prio) {
+			current->prio = r->ceiling;
+		}
+		return true;
 	}
-	if (current->age < current->lifespan) {		
-		if(cnt!=0){			
-            list_for_each(ptr, &readyqueue){
-                prc = list_entry(ptr, struct process, list);
-                if (max < prc->prio)
-                    max = prc->prio;
-            }         
-            if(current->prio <= max){ //preemption!
-                list_add_tail(&current->list, &readyqueue);
-                preemption_flag=1;
-                goto pick_next;          
-            }
-        }
-		current->prio = current->prio_orig;
+
+	prio_wait(r);
+	return false;
+}
+
+void pcp_release(int resource_id)
+{
+	struct resource *r = resources + resource_id;
+
+	assert(r->owner == current);
+
+	list_del_init(&r->owned);
+	r->owner = NULL;
+
+	/* Resources are not released in the reverse order of acquisition */
+	current->prio = pcp_ceiling_prio(current);
+
+	prio_wake_up(r);
+}
+
+static struct process *pcp_schedule(void)
+{
+	struct process *next;
+
+	if (!current || current->status == PROCESS_WAIT) {
+		goto pick_next;
+	}
+
+	if (current->age < current->lifespan) {
+		/* Preempt if a process with the same or higher priority is ready */
+		if (!prio_array_empty(&prio_rq) &&
+				current->prio <= prio_array_highest(&prio_rq)) {
+			prio_enqueue(current);
+			goto pick_next;
+		}
 		return current;
 	}
 
 pick_next:
-    if(cnt!=0){
-		 list_for_each(ptr, &readyqueue){
-            prc = list_entry(ptr, struct process, list);
-            if (max < prc->prio)
-                max = prc->prio;
-        }
-        list_for_each(ptr, &readyqueue){
-            prc = list_entry(ptr, struct process, list);
-            if (max == prc->prio && flag==0){
-				flag=1;
-				next=prc;
-            }
-			
-        }
-        list_del_init(&next->list);
-        next->prio = next->prio_orig;
+	next = prio_array_first(&prio_rq);
+	if (next) {
+		prio_dequeue(next);
 	}
 	return next;
 }
 
-struct scheduler pcp_scheduler = {
+const struct scheduler pcp_scheduler = {
 	.name = "Priority + PCP Protocol",
 	/**
 	 * Implement your own acqure/release function too to make priority
@@ -744,150 +1368,518 @@ struct scheduler pcp_scheduler = {
 	 */
     .acquire = pcp_acquire,
 	.release = pcp_release,
+	.initialize = prio_initialize,
 	.schedule = pcp_schedule,
+	.timeslice = prio_timeslice,
+	.enqueue = prio_enqueue,
+	.dequeue = prio_dequeue,
+	.nr_ready = prio_nr_ready,
+	.steal = prio_steal,
 };
 
 /***********************************************************************
  * Priority scheduler with priority inheritance protocol
  ***********************************************************************/
-bool pip_acquire(int resource_id){
-    struct resource *r = resources + resource_id;
-	struct list_head* ptr;
-	struct process* prc = NULL;
+/**
+ * The priority @p should run at; its own priority or the highest priority
+ * among the processes waiting for the resources @p owns
+ */
+static unsigned int pip_inherited_prio(struct process *p)
+{
+	unsigned int prio = p->prio_orig;
+	struct resource *r;
 
-	if (!r->owner) {
-		r->owner = current;
-		return true;
+	list_for_each_entry(r, &p->resources_owned, owned) {
+		struct heap_node *top = heap_peek(&r->waiters);
+
+		if (top && MAX_PRIO - top->key > prio) {
+			prio = MAX_PRIO - top->key;
+		}
 	}
+	return prio;
+}
 
-    if(r->owner->prio < current->prio){
-		//예시
-		//내(P1)가 잡고싶은 리소스(B)를 잡고있는 주인(P2)의 prio 상승 //원래
-		//주인(P2)이 누군가(P3)에게 prio 상승해준적 있으면, 그 누군가(P3)의 prio도 덩달아 상승
+/**
+ * Change the priority of @p to @prio wherever @p is
+ */
+static void pip_set_prio(struct process *p, unsigned int prio)
+{
+	if (p->blocked_on) {
+		/* Waiting for a resource */
+		p->prio = prio;
+		heap_update(&p->blocked_on->waiters, &p->node, prio_wait_key(p));
+	} else if (!list_empty(&p->list)) {
+		/* Ready */
+		prio_requeue(p, prio);
+	} else {
+		/* Running */
+		p->prio = prio;
+	}
+}
 
-		//레디큐 순회하면서 주인(P2)과 같은 prio 가진 프로세스(P3) 있다면?
-		list_for_each(ptr, &readyqueue){
-            prc = list_entry(ptr, struct process, list);
-			if(prc->prio == r->owner->prio && prc->prio_orig < r->owner->prio){
-				//이 경우에는 주인(P2)이 prc(P3)에게 prio를 상속해준 것
-				prc->prio = current->prio; //prc의 prio까지 덩달아 상승시켜줌
-			}
-        }      
-		r->owner->prio = current->prio;
+/**
+ * Recompute the priority of @p, and pass the change down to the owner of the
+ * resource @p is waiting for, to the owner of the resource that owner is
+ * waiting for, and so on
+ */
+static void pip_update_chain(struct process *p)
+{
+	while (p) {
+		unsigned int prio = pip_inherited_prio(p);
 
-    }
+		if (prio == p->prio) break;
 
-	current->status = PROCESS_WAIT;
-    list_add_tail(&current->list, &r->waitqueue);
+		pip_set_prio(p, prio);
 
-	return false;
- }
+		p = p->blocked_on ? p->blocked_on->owner : NULL;
+	}
+}
+
+bool pip_acquire(int resource_id)
+{
+	struct resource *r = resources + resource_id;
+
+	if (!r->owner) {
+		r->owner = current;
+		list_add_tail(&r->owned, &current->resources_owned);
+
+		/* Processes may have been waiting for it already */
+		pip_update_chain(current);
+		return true;
+	}
+
+	/* Donate the priority to the owner, and to the owners it waits for */
+	prio_wait(r);
+	pip_update_chain(r->owner);
 
-void pip_release(int resource_id){
-    int max=0;
-    int cnt=0;
-	struct list_head* ptr;
-	struct process* prc = NULL;
+	return false;
+}
 
-	struct process* waiter = NULL;
+void pip_release(int resource_id)
+{
 	struct resource *r = resources + resource_id;
 
 	assert(r->owner == current);
 
-    r->owner->prio = r->owner->prio_orig; //
-
+	list_del_init(&r->owned);
 	r->owner = NULL;
 
-	list_for_each(ptr, &r->waitqueue){
-        prc = list_entry(ptr, struct process, list);
-		cnt++;
-    }
+	prio_wake_up(r);
 
-	if (!list_empty(&r->waitqueue)) {
-	
-		list_for_each(ptr, &r->waitqueue){
-        	prc = list_entry(ptr, struct process, list);
-			if(max < prc->prio)
-				max = prc->prio;
-    	}
-		list_for_each(ptr, &r->waitqueue){
-            prc = list_entry(ptr, struct process, list);
-			if(prc->prio==max){
-				waiter = prc;
-				goto next;
-			}
-        }
-
-		next:
-		assert(waiter->status == PROCESS_WAIT);
-		list_del_init(&waiter->list);
-		waiter->status = PROCESS_READY;
-		list_add_tail(&waiter->list, &readyqueue);
-	}
+	/* Keep the donations from the waiters of the resources still owned */
+	pip_update_chain(current);
 }
 
-static struct process *pip_schedule(void){
-    struct list_head* ptr;
-    struct process* prc = NULL;
-	struct process* next = NULL;
-
-    int max=0; //prio의 max 찾기 위해
-    int cnt=0;
-	int flag=0;
-	int preemption_flag=0;
+static struct process *pip_schedule(void)
+{
+	struct process *next;
 
-	
-    list_for_each(ptr, &readyqueue){
-            prc = list_entry(ptr, struct process, list);
-            cnt++;
-        }
-	
-    if (!current || current->status == PROCESS_WAIT) {
+	if (!current || current->status == PROCESS_WAIT) {
 		goto pick_next;
 	}
-	if (current->age < current->lifespan) {		
-		if(cnt!=0){			
-            list_for_each(ptr, &readyqueue){
-                prc = list_entry(ptr, struct process, list);
-                if (max < prc->prio){
-                    max = prc->prio;
-                }
-            }    
-
-            if(current->prio <= max){ //preemption!
-                list_add_tail(&current->list, &readyqueue);
-                preemption_flag=1;
-                goto pick_next;          
-            }
-          
-        }
+
+	if (current->age < current->lifespan) {
+		/* Preempt if a process with the same or higher priority is ready */
+		if (!prio_array_empty(&prio_rq) &&
+				current->prio <= prio_array_highest(&prio_rq)) {
+			prio_enqueue(current);
+			goto pick_next;
+		}
 		return current;
 	}
 
 pick_next:
-    if(cnt!=0){
-		 list_for_each(ptr, &readyqueue){
-            prc = list_entry(ptr, struct process, list);
-            if (max < prc->prio)
-                max = prc->prio;
-        }
-
-        list_for_each(ptr, &readyqueue){
-            prc = list_entry(ptr, struct process, list);
-            if (max == prc->prio && flag==0){
-				flag=1;
-				next=prc;
-            }
-			
-        }
-        list_del_init(&next->list);
+	next = prio_array_first(&prio_rq);
+	if (next) {
+		prio_dequeue(next);
 	}
 	return next;
 }
 
-struct scheduler pip_scheduler = {
+const struct scheduler pip_scheduler = {
 	.name = "Priority + PIP Protocol",
 	.acquire = pip_acquire,
 	.release = pip_release,
+	.initialize = prio_initialize,
 	.schedule = pip_schedule,
+	.timeslice = prio_timeslice,
+	.enqueue = prio_enqueue,
+	.dequeue = prio_dequeue,
+	.nr_ready = prio_nr_ready,
+	.steal = prio_steal,
+};
+
+
+/***********************************************************************
+ * Deadline schedulers (EDF and RM)
+ ***********************************************************************/
+
+/**
+ * Ready queue of EDF and RM, ordered by @dl_key of processes. Processes with
+ * the same key come out in the order they became ready.
+ *
+ * The processes stay on the CPU they are admitted to so that the CPU can
+ * tell the utilization of its processes; there is no steal(). Nor is there
+ * drain() as the shares held for the exited processes (see dl_reservations)
+ * are not in a checkpoint.
+ */
+static __thread struct heap dl_rqs[MAX_CPUS];
+#define dl_rq	(dl_rqs[this_cpu])
+
+/**
+ * Sum of the shares of each CPU held for the processes admitted to it, and
+ * how many processes hold one. The shares are in the units of DL_UNIT
+ */
+#define DL_UNIT		(1UL << 20)
+
+static __thread unsigned long dl_utils[MAX_CPUS];
+#define dl_util	(dl_utils[this_cpu])
+
+static __thread unsigned int dl_nr_admitted[MAX_CPUS];
+
+/**
+ * A process exiting before its deadline keeps its share of the CPU until the
+ * deadline. Otherwise the processes admitted after it could take the time
+ * that the ones admitted before it still need by their deadlines
+ */
+struct dl_reservation {
+	struct heap_node node;		/* Keyed on the deadline */
+	unsigned long util;
+};
+
+static __thread struct heap dl_reservations[MAX_CPUS];
+static __thread struct pool dl_reservation_pool;
+
+/**
+ * The own key of a process, which the scheduler in use sets on initialize.
+ * @dl_key is this unless the process inherits a smaller one from its waiters
+ */
+static __thread unsigned int (*dl_own_key)(struct process *);
+
+static int dl_initialize(void)
+{
+	for (int i = 0; i < MAX_CPUS; i++) {
+		heap_init(dl_rqs + i);
+		heap_init(dl_reservations + i);
+		dl_utils[i] = 0;
+		dl_nr_admitted[i] = 0;
+	}
+	pool_init(&dl_reservation_pool, sizeof(struct dl_reservation), 64);
+	return 0;
+}
+
+static void dl_finalize(void)
+{
+	for (int i = 0; i < MAX_CPUS; i++) {
+		heap_destroy(dl_rqs + i);
+		heap_destroy(dl_reservations + i);
+	}
+	pool_destroy(&dl_reservation_pool);
+}
+
+static unsigned int dl_nr_ready(void)
+{
+	return dl_rq.nr;
+}
+
+static void dl_enqueue(struct process *p)
+{
+	heap_push(&dl_rq, &p->node, p->dl_key);
+}
+
+static void dl_dequeue(struct process *p)
+{
+	heap_remove(&dl_rq, &p->node);
+}
+
+/**
+ * Take out the most urgent process. NULL if no process is ready
+ */
+static struct process *dl_pick_next(void)
+{
+	struct heap_node *node = heap_pop(&dl_rq);
+
+	return node ? container_of(node, struct process, node) : NULL;
+}
+
+/**
+ * The share of a CPU @p needs to meet its deadline; the lifespan over the
+ * deadline, or over the period if it is shorter. Rounded up not to admit a
+ * process that does not fit
+ */
+static unsigned long dl_utilization(struct process *p)
+{
+	unsigned int window = p->deadline;
+
+	if (!window) return 0;
+	if (p->period && p->period < window) window = p->period;
+
+	return (p->lifespan * DL_UNIT + window - 1) / window;
+}
+
+/**
+ * Give back the shares held for the exited processes whose deadline has come
+ */
+static void dl_expire_reservations(void)
+{
+	struct heap *h = dl_reservations + this_cpu;
+
+	while (!heap_empty(h) && heap_peek(h)->key <= ticks) {
+		struct dl_reservation *r =
+				container_of(heap_pop(h), struct dl_reservation, node);
+
+		dl_util -= r->util;
+		dl_nr_admitted[this_cpu]--;
+		pool_free(&dl_reservation_pool, r);
+	}
+}
+
+/**
+ * Admit @p to @this_cpu if the utilization stays within @bound with @p. The
+ * expired shares should have been given back beforehand
+ */
+static bool dl_admit(struct process *p, unsigned long bound)
+{
+	unsigned long util = dl_utilization(p);
+
+	if (util) {
+		if (dl_util + util > bound) return false;
+
+		dl_util += util;
+		dl_nr_admitted[this_cpu]++;
+	}
+
+	/* Before getting into the ready queue */
+	p->dl_key = dl_own_key(p);
+	return true;
+}
+
+static void dl_exiting(struct process *p)
+{
+	unsigned long util = dl_utilization(p);
+	struct dl_reservation *r;
+
+	if (!util) return;
+
+	if (p->deadline_at <= ticks) {
+		dl_util -= util;
+		dl_nr_admitted[this_cpu]--;
+		return;
+	}
+
+	r = pool_alloc(&dl_reservation_pool);
+	r->util = util;
+	heap_push(dl_reservations + this_cpu, &r->node, p->deadline_at);
+}
+
+/**
+ * The key @p should run at; its own key or the smallest key among the
+ * processes waiting for the resources @p owns. It is the priority inheritance
+ * of the PIP protocol where a smaller key is a higher priority
+ */
+static unsigned int dl_inherited_key(struct process *p)
+{
+	unsigned int key = dl_own_key(p);
+	struct resource *r;
+
+	list_for_each_entry(r, &p->resources_owned, owned) {
+		struct heap_node *top = heap_peek(&r->waiters);
+
+		if (top && top->key < key) key = top->key;
+	}
+	return key;
+}
+
+/**
+ * Change the key of @p to @key wherever @p is
+ */
+static void dl_set_key(struct process *p, unsigned int key)
+{
+	p->dl_key = key;
+
+	if (p->blocked_on) {
+		/* Waiting for a resource */
+		heap_update(&p->blocked_on->waiters, &p->node, key);
+	} else if (heap_contains(dl_rqs + p->cpu, &p->node)) {
+		/* Ready, maybe on another CPU */
+		heap_update(dl_rqs + p->cpu, &p->node, key);
+	}
+}
+
+/**
+ * Recompute the key of @p, and pass the change down the chain of the owners
+ * as pip_update_chain() does
+ */
+static void dl_update_chain(struct process *p)
+{
+	while (p) {
+		unsigned int key = dl_inherited_key(p);
+
+		if (key == p->dl_key) break;
+
+		dl_set_key(p, key);
+
+		p = p->blocked_on ? p->blocked_on->owner : NULL;
+	}
+}
+
+bool dl_acquire(int resource_id)
+{
+	struct resource *r = resources + resource_id;
+
+	if (!r->owner) {
+		r->owner = current;
+		list_add_tail(&r->owned, &current->resources_owned);
+
+		/* Processes may have been waiting for it already */
+		dl_update_chain(current);
+		return true;
+	}
+
+	/* Wait in the order of the key, and lend the key to the owners */
+	current->status = PROCESS_WAIT;
+	current->blocked_on = r;
+	heap_push(&r->waiters, &current->node, current->dl_key);
+
+	dl_update_chain(r->owner);
+	return false;
+}
+
+void dl_release(int resource_id)
+{
+	struct resource *r = resources + resource_id;
+
+	assert(r->owner == current);
+
+	list_del_init(&r->owned);
+	r->owner = NULL;
+
+	/* The waiter with the smallest key */
+	prio_wake_up(r);
+
+	dl_update_chain(current);
+}
+
+/**
+ * Keep the current until a more urgent process gets ready
+ */
+static unsigned int dl_timeslice(void)
+{
+	struct heap_node *top = heap_peek(&dl_rq);
+
+	return top && top->key < current->dl_key ? 0 : UINT_MAX;
+}
+
+static struct process *dl_schedule(void)
+{
+	struct heap_node *top;
+
+	if (!current || current->status == PROCESS_WAIT) {
+		goto pick_next;
+	}
+
+	if (current->age < current->lifespan) {
+		/* Preempt only for a strictly more urgent process */
+		top = heap_peek(&dl_rq);
+		if (top && top->key < current->dl_key) {
+			dl_enqueue(current);
+			goto pick_next;
+		}
+		return current;
+	}
+
+pick_next:
+	return dl_pick_next();
+}
+
+/**
+ * Earliest deadline first. Processes without a deadline run when no process
+ * with a deadline is ready
+ */
+static unsigned int edf_key(struct process *p)
+{
+	return p->deadline_at;
+}
+
+static int edf_initialize(void)
+{
+	dl_own_key = edf_key;
+	return dl_initialize();
+}
+
+/**
+ * EDF meets all the deadlines on a CPU as long as it is not overloaded
+ */
+static bool edf_admit(struct process *p)
+{
+	dl_expire_reservations();
+	return dl_admit(p, DL_UNIT);
+}
+
+const struct scheduler edf_scheduler = {
+	.name = "Earliest Deadline First",
+	.acquire = dl_acquire,
+	.release = dl_release,
+	.initialize = edf_initialize,
+	.finalize = dl_finalize,
+	.admit = edf_admit,
+	.exiting = dl_exiting,
+	.schedule = dl_schedule,
+	.timeslice = dl_timeslice,
+	.enqueue = dl_enqueue,
+	.dequeue = dl_dequeue,
+	.nr_ready = dl_nr_ready,
+};
+
+/**
+ * Rate-monotonic. The shorter the period is, the more urgent the process is.
+ * Processes with a deadline but no period are ranked by the deadline as if
+ * it were their period, and the ones with neither run in the background
+ */
+static unsigned int rm_key(struct process *p)
+{
+	if (p->period) return p->period;
+	return p->deadline ? p->deadline : UINT_MAX;
+}
+
+static int rm_initialize(void)
+{
+	dl_own_key = rm_key;
+	return dl_initialize();
+}
+
+/**
+ * The utilization bound of Liu and Layland, n(2^(1/n) - 1), for n processes
+ * in DL_UNIT. It approaches ln 2 as n grows
+ */
+static const unsigned long rm_bounds[] = {
+	1048576, 868668, 817640, 793592, 779607, 770464, 764020, 759233,
+	755538, 752599, 750205, 748218, 746543, 745110, 743872, 742790,
+};
+#define RM_BOUND_LIMIT	726817
+
+static bool rm_admit(struct process *p)
+{
+	unsigned int n;
+
+	dl_expire_reservations();
+	n = dl_nr_admitted[this_cpu] + 1;
+
+	return dl_admit(p, n <= sizeof(rm_bounds) / sizeof(rm_bounds[0]) ?
+			rm_bounds[n - 1] : RM_BOUND_LIMIT);
+}
+
+const struct scheduler rm_scheduler = {
+	.name = "Rate-Monotonic",
+	.acquire = dl_acquire,
+	.release = dl_release,
+	.initialize = rm_initialize,
+	.finalize = dl_finalize,
+	.admit = rm_admit,
+	.exiting = dl_exiting,
+	.schedule = dl_schedule,
+	.timeslice = dl_timeslice,
+	.enqueue = dl_enqueue,
+	.dequeue = dl_dequeue,
+	.nr_ready = dl_nr_ready,
 };
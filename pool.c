@@ -0,0 +1,110 @@
+/**********************************************************************
+ * Copyright (c) 2019-2021
+ *  Sang-Hoon Kim <sanghoonkim@ajou.ac.kr>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTIABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ **********************************************************************/
+
+#include <stdlib.h>
+#include <assert.h>
+
+#include "pool.h"
+
+/* Do not let a chunk grow beyond this many objects */
+#define POOL_MAX_CHUNK_OBJS	(1UL << 16)
+
+struct pool_chunk {
+	struct pool_chunk *next;
+	size_t nr_objs;			/* # of objects in @objs */
+	union {					/* Align objects as malloc() does */
+		long double ld;
+		void *ptr;
+		unsigned long long ull;
+	} objs[];
+};
+
+/* A freed object links to the next free one with its first word */
+struct pool_free_obj {
+	struct pool_free_obj *next;
+};
+
+void pool_init(struct pool *pool, size_t objsize, size_t nr_objs)
+{
+	size_t align = sizeof(((struct pool_chunk *)0)->objs[0]);
+
+	if (objsize < sizeof(struct pool_free_obj)) {
+		objsize = sizeof(struct pool_free_obj);
+	}
+
+	pool->objsize = (objsize + align - 1) / align * align;
+	pool->nr_per_chunk = nr_objs ? nr_objs : 1;
+	pool->chunks = NULL;
+	pool->nr_carved = 0;
+	pool->free = NULL;
+}
+
+void pool_destroy(struct pool *pool)
+{
+	struct pool_chunk *chunk = pool->chunks;
+
+	while (chunk) {
+		struct pool_chunk *next = chunk->next;
+		free(chunk);
+		chunk = next;
+	}
+	pool->chunks = NULL;
+	pool->nr_carved = 0;
+	pool->free = NULL;
+}
+
+static void __pool_grow(struct pool *pool)
+{
+	size_t nr_objs = pool->nr_per_chunk;
+	struct pool_chunk *chunk =
+			malloc(sizeof(*chunk) + pool->objsize * nr_objs);
+	assert(chunk);
+
+	chunk->next = pool->chunks;
+	chunk->nr_objs = nr_objs;
+	pool->chunks = chunk;
+	pool->nr_carved = 0;
+
+	/* Double the next chunk, so the # of chunks stays logarithmic */
+	if (nr_objs < POOL_MAX_CHUNK_OBJS) {
+		pool->nr_per_chunk = nr_objs * 2;
+	}
+}
+
+void *pool_alloc(struct pool *pool)
+{
+	char *obj;
+
+	if (pool->free) {
+		struct pool_free_obj *f = pool->free;
+		pool->free = f->next;
+		return f;
+	}
+
+	if (!pool->chunks || pool->nr_carved == pool->chunks->nr_objs) {
+		__pool_grow(pool);
+	}
+
+	obj = (char *)pool->chunks->objs + pool->objsize * pool->nr_carved++;
+	return obj;
+}
+
+void pool_free(struct pool *pool, void *obj)
+{
+	struct pool_free_obj *f = obj;
+
+	f->next = pool->free;
+	pool->free = f;
+}
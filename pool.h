@@ -0,0 +1,63 @@
+/**********************************************************************
+ * Copyright (c) 2019-2021
+ *  Sang-Hoon Kim <sanghoonkim@ajou.ac.kr>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTIABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ **********************************************************************/
+
+#ifndef __POOL_H__
+#define __POOL_H__
+
+#include <stddef.h>
+
+/**
+ * Object pool handing out fixed-size objects from large chunks. Objects
+ * allocated one after another sit next to each other in memory, and all of
+ * them go away at once with pool_destroy().
+ *
+ * Objects given back with pool_free() are kept in a free list and handed
+ * out again by pool_alloc() before carving a new one out of the chunk.
+ */
+struct pool_chunk;
+
+struct pool {
+	size_t objsize;			/* Size of an object, rounded up for alignment */
+	size_t nr_per_chunk;	/* # of objects in the next chunk to allocate */
+
+	struct pool_chunk *chunks;	/* Chunks allocated so far, the latest first */
+	size_t nr_carved;		/* # of objects carved out of @chunks */
+
+	void *free;				/* Objects freed to the pool */
+};
+
+/**
+ * pool_init - initialize @pool for objects of @objsize bytes. The first
+ * chunk holds @nr_objs objects, and chunks grow in size as they are used up.
+ * Give an estimation of the # of objects if known to allocate them at once
+ */
+void pool_init(struct pool *pool, size_t objsize, size_t nr_objs);
+
+/**
+ * pool_destroy - release all the objects and chunks of @pool at once
+ */
+void pool_destroy(struct pool *pool);
+
+/**
+ * pool_alloc - allocate an object from @pool. The object is not cleared
+ */
+void *pool_alloc(struct pool *pool);
+
+/**
+ * pool_free - give @obj back to @pool for later pool_alloc()
+ */
+void pool_free(struct pool *pool, void *obj);
+
+#endif
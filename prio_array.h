@@ -0,0 +1,116 @@
+/**********************************************************************
+ * Copyright (c) 2019-2021
+ *  Sang-Hoon Kim <sanghoonkim@ajou.ac.kr>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTIABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ **********************************************************************/
+
+#ifndef __PRIO_ARRAY_H__
+#define __PRIO_ARRAY_H__
+
+/**
+ * Multi-level queue of processes with one list per priority level
+ * (0 .. MAX_PRIO). Processes above MAX_PRIO are at the MAX_PRIO level in the
+ * order they came in. @bitmap keeps track of non-empty levels so that finding
+ * the highest priority process takes a find-last-set per bitmap word instead
+ * of a walk over all processes. Processes are linked through @list, and
+ * processes at the same level are kept in FIFO order.
+ *
+ * Include types.h, list_head.h, and process.h before this file.
+ */
+#include "bitmap.h"
+
+#define PRIO_LEVELS			(MAX_PRIO + 1)
+#define PRIO_BITMAP_LONGS	BITS_TO_LONGS(PRIO_LEVELS)
+
+struct prio_array {
+	unsigned int nr_active;		/* # of processes in the array */
+	unsigned long bitmap[PRIO_BITMAP_LONGS];
+								/* Bit n is set if @queue[n] is not empty */
+	struct list_head queue[PRIO_LEVELS];
+};
+
+static inline void prio_array_init(struct prio_array *a)
+{
+	a->nr_active = 0;
+	for (int i = 0; i < PRIO_BITMAP_LONGS; i++) {
+		a->bitmap[i] = 0;
+	}
+	for (int i = 0; i < PRIO_LEVELS; i++) {
+		INIT_LIST_HEAD(a->queue + i);
+	}
+}
+
+static inline bool prio_array_empty(const struct prio_array *a)
+{
+	return a->nr_active == 0;
+}
+
+static inline unsigned int prio_array_level(const struct process *p)
+{
+	return p->prio < MAX_PRIO ? p->prio : MAX_PRIO;
+}
+
+/**
+ * prio_array_enqueue - put @p at the tail of the level of @p->prio
+ *
+ * @p->prio should not be changed while @p is in the array. Take it out,
+ * update the priority, and put it back instead.
+ */
+static inline void prio_array_enqueue(struct prio_array *a, struct process *p)
+{
+	unsigned int prio = prio_array_level(p);
+
+	list_add_tail(&p->list, a->queue + prio);
+	a->bitmap[prio / BITS_PER_LONG] |= 1UL << (prio % BITS_PER_LONG);
+	a->nr_active++;
+}
+
+static inline void prio_array_dequeue(struct prio_array *a, struct process *p)
+{
+	unsigned int prio = prio_array_level(p);
+
+	list_del_init(&p->list);
+	if (list_empty(a->queue + prio)) {
+		a->bitmap[prio / BITS_PER_LONG] &= ~(1UL << (prio % BITS_PER_LONG));
+	}
+	a->nr_active--;
+}
+
+/**
+ * prio_array_highest - the highest priority level having a process.
+ * Returns -1 if the array is empty
+ */
+static inline int prio_array_highest(const struct prio_array *a)
+{
+	for (int i = PRIO_BITMAP_LONGS - 1; i >= 0; i--) {
+		if (a->bitmap[i]) {
+			return i * BITS_PER_LONG +
+					(BITS_PER_LONG - 1 - __builtin_clzl(a->bitmap[i]));
+		}
+	}
+	return -1;
+}
+
+/**
+ * prio_array_first - the process that came first among the processes with
+ * the highest priority. NULL if the array is empty
+ */
+static inline struct process *prio_array_first(const struct prio_array *a)
+{
+	int prio = prio_array_highest(a);
+
+	if (prio < 0) return NULL;
+
+	return list_first_entry(a->queue + prio, struct process, list);
+}
+
+#endif
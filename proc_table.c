@@ -0,0 +1,136 @@
+/**********************************************************************
+ * Copyright (c) 2019-2021
+ *  Sang-Hoon Kim <sanghoonkim@ajou.ac.kr>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTIABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ **********************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+#include "types.h"
+#include "list_head.h"
+#include "heap.h"
+#include "process.h"
+#include "proc_table.h"
+#include "scan.h"
+
+__thread struct process **process_slots = NULL;
+
+static __thread unsigned int __nr_slots;	/* # of slots ever used */
+static __thread unsigned int __slots_size;	/* # of slots allocated */
+static __thread unsigned int *__free_slots;	/* Stack of the slots to reuse */
+static __thread unsigned int __nr_free_slots;
+
+void proc_slots_init(void)
+{
+	process_slots = NULL;
+	__nr_slots = __slots_size = 0;
+	__free_slots = NULL;
+	__nr_free_slots = 0;
+}
+
+void proc_slots_destroy(void)
+{
+	free(process_slots);
+	free(__free_slots);
+	proc_slots_init();
+}
+
+void proc_slot_alloc(struct process *p)
+{
+	if (__nr_free_slots) {
+		p->slot = __free_slots[--__nr_free_slots];
+	} else {
+		if (__nr_slots == __slots_size) {
+			__slots_size = __slots_size ? __slots_size * 2 : 64;
+			process_slots = realloc(process_slots,
+					sizeof(*process_slots) * __slots_size);
+			__free_slots = realloc(__free_slots,
+					sizeof(*__free_slots) * __slots_size);
+			assert(process_slots && __free_slots);
+		}
+		p->slot = __nr_slots++;
+	}
+	process_slots[p->slot] = p;
+}
+
+void proc_slot_free(struct process *p)
+{
+	assert(process_slots[p->slot] == p);
+
+	process_slots[p->slot] = NULL;
+	__free_slots[__nr_free_slots++] = p->slot;
+}
+
+unsigned int proc_slots_nr(void)
+{
+	return __nr_slots;
+}
+
+
+void proc_table_init(struct proc_table *t)
+{
+	t->nr = t->size = 0;
+	t->slot = NULL;
+	t->prio = NULL;
+}
+
+void proc_table_destroy(struct proc_table *t)
+{
+	free(t->slot);
+	free(t->prio);
+	proc_table_init(t);
+}
+
+void proc_table_push(struct proc_table *t, struct process *p)
+{
+	if (t->nr == t->size) {
+		t->size = t->size ? t->size * 2 : 64;
+		t->slot = realloc(t->slot, sizeof(*t->slot) * t->size);
+		t->prio = realloc(t->prio, sizeof(*t->prio) * t->size);
+		assert(t->slot && t->prio);
+	}
+	t->slot[t->nr] = p->slot;
+	t->prio[t->nr] = p->prio;
+	t->nr++;
+}
+
+struct process *proc_table_remove(struct proc_table *t, unsigned int pos)
+{
+	struct process *p;
+
+	assert(pos < t->nr);
+
+	p = process_slots[t->slot[pos]];
+	p->prio = t->prio[pos];
+
+	t->nr--;
+	memmove(t->slot + pos, t->slot + pos + 1, sizeof(*t->slot) * (t->nr - pos));
+	memmove(t->prio + pos, t->prio + pos + 1, sizeof(*t->prio) * (t->nr - pos));
+	return p;
+}
+
+unsigned int proc_table_find(const struct proc_table *t, const struct process *p)
+{
+	return scan_find(t->slot, t->nr, p->slot);
+}
+
+unsigned int proc_table_highest(const struct proc_table *t)
+{
+	return scan_argmax(t->prio, t->nr);
+}
+
+void proc_table_age(struct proc_table *t, unsigned int max)
+{
+	scan_inc_sat(t->prio, t->nr, max);
+}
@@ -0,0 +1,92 @@
+/**********************************************************************
+ * Copyright (c) 2019-2021
+ *  Sang-Hoon Kim <sanghoonkim@ajou.ac.kr>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTIABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ **********************************************************************/
+
+#ifndef __PROC_TABLE_H__
+#define __PROC_TABLE_H__
+
+struct process;
+
+/**
+ * Each process alive in the simulation has a slot, which is a dense index
+ * from 0. The slots of exited processes are reused, so they stay below the
+ * peak # of live processes. @process_slots maps the slots to the processes,
+ * so compact structures can refer to processes with 32-bit slots instead of
+ * pointers. The framework assigns process->slot before forking a process and
+ * frees it when the process exits.
+ */
+extern __thread struct process **process_slots;
+
+void proc_slots_init(void);
+void proc_slots_destroy(void);
+void proc_slot_alloc(struct process *p);
+void proc_slot_free(struct process *p);
+
+/**
+ * proc_slots_nr - # of slots ever used. The free ones among them are NULL in
+ * @process_slots
+ */
+unsigned int proc_slots_nr(void);
+
+/**
+ * Queue of processes for schedulers that look at every queued process to
+ * pick the next one. Instead of walking a list through the processes, a scan
+ * streams through the fields it reads, which are kept in contiguous arrays by
+ * the position in the queue. Position 0 is the head, and the processes stay
+ * in the order they were pushed. So picking the first among the processes
+ * with the best key breaks ties in the FIFO order as list-based queues do.
+ *
+ * While a process is in the table, @prio of its entry is its priority, which
+ * the process gets back in process->prio when it is taken out. The scans go
+ * through the kernels in scan.h.
+ */
+struct proc_table {
+	unsigned int nr;		/* # of processes in the table */
+	unsigned int size;		/* # of entries allocated */
+	unsigned int *slot;		/* Slot of the process at each position */
+	unsigned int *prio;		/* And its priority */
+};
+
+void proc_table_init(struct proc_table *t);
+void proc_table_destroy(struct proc_table *t);
+
+/**
+ * proc_table_push - put @p at the tail of @t with @p->prio
+ */
+void proc_table_push(struct proc_table *t, struct process *p);
+
+/**
+ * proc_table_remove - take out the process at @pos, keeping the order of the
+ * others. Return the process with its priority in the table
+ */
+struct process *proc_table_remove(struct proc_table *t, unsigned int pos);
+
+/**
+ * proc_table_find - the position of @p in @t. @t->nr if it is not in @t
+ */
+unsigned int proc_table_find(const struct proc_table *t, const struct process *p);
+
+/**
+ * proc_table_highest - the first position among the processes with the
+ * highest priority. @t->nr if @t is empty
+ */
+unsigned int proc_table_highest(const struct proc_table *t);
+
+/**
+ * proc_table_age - raise the priority of every process in @t by one up to @max.
+ * The priorities should not be larger than @max
+ */
+void proc_table_age(struct proc_table *t, unsigned int max);
+
+#endif
@@ -17,6 +17,8 @@
 #define __PROCESS_H__
 
 struct list_head;
+struct heap_node;
+struct resource;
 
 enum process_status {
 	PROCESS_READY,		/* Process is ready to run */
@@ -41,11 +43,50 @@ struct process {
 
 	struct list_head list;	/* list head for listing processes */
 
+	unsigned int cpu;		/* The CPU the process runs on, or is ready to
+							   run on */
+
+	struct heap_node node;	/* heap node for the heap the process is in, which
+							   is either the ready queue of SJF, SRTF, EDF,
+							   and RM, the saturated level of the aging
+							   priority scheduler, or the waiters of the
+							   resource it is waiting for (@blocked_on) */
+
 	/**
 	 * You might need following(s) to implement dynamic priority features
 	 */
 	unsigned int prio_orig;	/* The original priority of the process */
 
+	unsigned int enqueued_at;	/* When the process entered the ready queue.
+								   Aging schedulers derive how much the process
+								   has aged from it instead of boosting @prio
+								   of every waiter on every tick */
+
+	struct resource *blocked_on;	/* The resource the process is waiting for.
+									   NULL if it is not waiting */
+
+	struct list_head resources_owned;
+								/* Resources the process owns, linked through
+								   resource->owned. Priority inheritance takes
+								   the donations from the waiters of these */
+
+	unsigned int slice_start;	/* @age when the current time slice began */
+
+	unsigned int slot;		/* Slot of the process while it is alive. See
+							   proc_table.h */
+
+	unsigned int level;		/* Level in the multi-level feedback queue */
+	unsigned int boosted_at;	/* The last boost period applied to @level */
+
+	unsigned int period;	/* Period of the task the process is a job of. 0
+							   if it is not periodic */
+	unsigned int deadline;	/* Deadline relative to the fork. The period if
+							   not given, and 0 if neither is given */
+	unsigned int deadline_at;	/* The tick to exit by. UINT_MAX if there is
+								   no deadline. Set by the framework on fork */
+	unsigned int dl_key;	/* Effective key of the deadline schedulers (EDF
+							   and RM). The smaller, the more urgent */
+
 
 	/** DO NOT ACCESS FOLLOWING VARIABLES **/
 	unsigned int __starts_at;	/* When to fork the process */
@@ -53,8 +94,16 @@ struct process {
 	struct list_head __resources_to_acquire;
 								/* Schedule to acquire resources */
 
-	struct list_head __resources_holding;
-								/* Resources that the process is currently holding */
+	struct heap __resources_holding;
+								/* Resources that the process is currently holding,
+								   keyed on the @age to release them */
+
+	unsigned int __forked_at;	/* Metrics. See metrics.h */
+	unsigned int __first_run_at;
+	unsigned int __blocked_ticks;
+	unsigned int __waiting_since;	/* The first tick waiting for a resource
+									   after blocked. 0 if not waiting */
+	unsigned int __waiting_ticks;
 };
 
 /**
@@ -62,6 +111,18 @@ struct process {
  */
 void dump_status(void);
 
+/**
+ * Put @process into the ready queue of the scheduler in use. It is the same
+ * as list_add_tail(&process->list, &readyqueue) unless the scheduler keeps
+ * its own ready queue (see @enqueue in sched.h)
+ */
+void enqueue_process(struct process *process);
+
+/**
+ * Take @process, which enqueue_process() put in the ready queue, out of it
+ */
+void dequeue_process(struct process *process);
+
 #define MAX_PRIO	64	/* Maximum value for priority */
 
 #endif
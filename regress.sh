@@ -0,0 +1,198 @@
+#!/bin/bash
+#
+# Differential regression test of the scheduler simulator
+#
+#   ./regress.sh [-u] [-r reference binary] [-g # of generated workloads]
+#
+# Every scheduler runs on every testcase, and the event stream (stderr) is
+# compared with the golden output in testcases/golden. Run with -u to
+# regenerate the golden outputs after an intended change of a schedule.
+#
+# Then it runs every scheduler on workloads generated by wlgen and checks
+# that the event-driven mode (-e), the binary trace (-T), and the plain C scan
+# kernels (SCHED_SCAN=scalar, see scan.h) give exactly the same event stream
+# as the plain simulation, that continuing from a checkpoint (-K and -R) in
+# the middle gives the rest of the stream for the schedulers that can be
+# checkpointed, and that streaming the processes (-F) and the specialized
+# build (sched-spec, if built) give the same stream. Half of the workloads
+# have periodic processes with deadlines for EDF (-d) and RM (-t), and EDF
+# should meet the deadline of every process it admits on workloads without
+# resources to wait for.
+# With -r, the event streams are compared with the ones of the reference
+# binary (e.g., ./sched5 or a build of an older revision) as well, both on the
+# testcases and the generated workloads. Schedulers the reference does not
+# know are skipped, and so are the workloads with deadlines.
+#
+# For each mismatch, the first divergent tick is reported.
+
+FLAGS=${FLAGS:-f s S r m p a P c i d t}
+GOLDEN=testcases/golden
+NR_GENERATED=20
+REF_TIMEOUT=${REF_TIMEOUT:-10}
+REF=
+UPDATE=
+
+while getopts "ur:g:h" opt; do
+	case $opt in
+	u) UPDATE=1 ;;
+	r) REF=$OPTARG ;;
+	g) NR_GENERATED=$OPTARG ;;
+	*) sed -n '3,4p' "$0" | cut -c3-; exit 1 ;;
+	esac
+done
+
+[ -n "$REF" ] && REF=$(realpath "$REF")
+cd "$(dirname "$0")" || exit 1
+
+TMP=$(mktemp -d)
+trap 'rm -rf "$TMP"' EXIT
+
+nr_checks=0
+nr_failures=0
+
+# Tell where the event streams in $2 (expected) and $3 differ for test $1
+report() {
+	local out line expected got
+
+	nr_failures=$((nr_failures + 1))
+
+	out=$(cmp "$2" "$3" 2>&1)
+	line=$(echo "$out" | sed -n 's/.* line \([0-9]*\).*/\1/p')
+	case $out in
+	*EOF*) line=$((line + 1)) ;;
+	esac
+
+	expected=$(sed -n "${line}p" "$2")
+	got=$(sed -n "${line}p" "$3")
+
+	echo "FAIL $1"
+	echo "    first divergence at tick $(echo "${expected:-$got}" | cut -d: -f1 | tr -d ' ') (line $line)"
+	echo "    expected: ${expected:-<end of stream>}"
+	echo "    got:      ${got:-<end of stream>}"
+}
+
+# Run test $1 expecting the event stream in $2 to be the same as the one in $3
+check() {
+	nr_checks=$((nr_checks + 1))
+	cmp -s "$2" "$3" || report "$1" "$2" "$3"
+}
+
+# Whether the reference binary knows scheduler $1
+ref_supports() {
+	"$REF" -q -$1 testcases/single > /dev/null 2>&1
+}
+
+# Run the reference binary with scheduler $2 on workload $3 for test $1, and
+# compare the event stream with the one in $4. A reference that crashes or
+# does not finish in $REF_TIMEOUT seconds fails the test as well
+check_ref() {
+	local status
+
+	(timeout $REF_TIMEOUT "$REF" -q -$2 "$3" 2> "$TMP/ref" > /dev/null) 2> /dev/null
+	status=$?
+	if [ $status -ne 0 ]; then
+		nr_checks=$((nr_checks + 1))
+		nr_failures=$((nr_failures + 1))
+		if [ $status -eq 124 ]; then
+			echo "FAIL $1: $REF did not finish in $REF_TIMEOUT seconds"
+		else
+			echo "FAIL $1: $REF exited with $status"
+		fi
+		return
+	fi
+	check "$1" "$TMP/ref" "$4"
+}
+
+# Testcases against the golden outputs and the reference
+mkdir -p $GOLDEN
+for t in testcases/*; do
+	[ -f "$t" ] || continue
+	name=$(basename "$t")
+
+	for f in $FLAGS; do
+		./sched -q -$f "$t" 2> "$TMP/out" > /dev/null
+
+		if [ -n "$UPDATE" ]; then
+			cp "$TMP/out" "$GOLDEN/$name.$f"
+		else
+			check "$name -$f" "$GOLDEN/$name.$f" "$TMP/out"
+		fi
+
+		if [ -n "$REF" ] && ref_supports $f; then
+			check_ref "$name -$f vs $REF" $f "$t" "$TMP/out"
+		fi
+	done
+done
+
+# Generated workloads of diverse shapes
+for seed in $(seq 1 "$NR_GENERATED"); do
+	case $((seed % 4)) in
+	0) shape="-a poisson -l exp" ;;
+	1) shape="-a bursty -l exp" ;;
+	2) shape="-a poisson -l pareto -m 5" ;;
+	3) shape="-a bursty -l pareto -m 5" ;;
+	esac
+
+	# Periods and deadlines, which the reference may not know
+	deadlines=
+	[ $((seed % 2)) -eq 0 ] && deadlines="-e 0.5 -u 0.2 -d 0.3"
+
+	wl="$TMP/gen-$seed"
+	./wlgen -n 200 -r 3 -c 0.5 -s $seed $shape $deadlines -t "$wl" || exit 1
+
+	for f in $FLAGS; do
+		name="generated seed $seed -$f"
+
+		./sched -q -$f -T "$TMP/trace" "$wl" 2> "$TMP/out" > /dev/null
+
+		./sched -q -e -$f "$wl" 2> "$TMP/event" > /dev/null
+		check "$name -e" "$TMP/out" "$TMP/event"
+
+		./tracedump "$TMP/trace" 2> "$TMP/dump" > /dev/null
+		check "$name -T" "$TMP/out" "$TMP/dump"
+
+		SCHED_SCAN=scalar ./sched -q -$f "$wl" 2> "$TMP/scalar" > /dev/null
+		check "$name SCHED_SCAN=scalar" "$TMP/out" "$TMP/scalar"
+
+		# The first half, and the rest from the checkpoint in between. Skip
+		# the schedulers that cannot be checkpointed
+		half=$(($(tail -n 1 "$TMP/out" | cut -d: -f1) / 2))
+		if ./sched -q -$f -K $half:"$TMP/image" "$wl" 2> "$TMP/first" > /dev/null ||
+				! grep -q "cannot be checkpointed" "$TMP/first"; then
+			./sched -q -R "$TMP/image" 2>> "$TMP/first" > /dev/null
+			check "$name -K $half" "$TMP/out" "$TMP/first"
+		fi
+
+		./sched -q -F -$f "$wl" 2> "$TMP/stream" > /dev/null
+		check "$name -F" "$TMP/out" "$TMP/stream"
+
+		if [ -x ./sched-spec ]; then
+			./sched-spec -q -$f "$wl" 2> "$TMP/spec" > /dev/null
+			check "$name sched-spec" "$TMP/out" "$TMP/spec"
+		fi
+
+		if [ -n "$REF" ] && [ -z "$deadlines" ] && ref_supports $f; then
+			check_ref "$name vs $REF" $f "$wl" "$TMP/out"
+		fi
+	done
+done
+
+# EDF admits no more than a CPU can finish by the deadlines. Only waiting for
+# resources may make an admitted process late
+for seed in $(seq 1 "$NR_GENERATED"); do
+	wl="$TMP/edf-$seed"
+	./wlgen -n 200 -i 2 -s $seed -e 0.8 -u 0.3 -d 0.5 "$wl" || exit 1
+
+	nr_checks=$((nr_checks + 1))
+	missed=$(./sched -q -M -d "$wl" 2> /dev/null | sed -n 's/.* deadlines, \([0-9]*\) missed.*/\1/p')
+	if [ "$missed" != 0 ]; then
+		nr_failures=$((nr_failures + 1))
+		echo "FAIL generated seed $seed -d: ${missed:-no} deadlines missed"
+	fi
+done
+
+if [ -n "$UPDATE" ]; then
+	echo "Updated the golden outputs in $GOLDEN"
+fi
+echo "$((nr_checks - nr_failures)) of $nr_checks checks passed"
+[ $nr_failures -eq 0 ]
@@ -18,6 +18,7 @@
 
 struct process;
 struct list_head;
+struct heap;
 
 /**
  * Resources in the system.
@@ -29,16 +30,44 @@ struct resource {
 	 */
 	struct process *owner;
 
+	/**
+	 * list head to link the resource to @owner->resources_owned
+	 */
+	struct list_head owned;
+
 	/**
 	 * list head to list processes that are wanting for the resource
 	 */
 	struct list_head waitqueue;
+
+	/**
+	 * Processes wanting for the resource, ordered by priority. Priority
+	 * schedulers put waiters here instead of @waitqueue so that the waiter
+	 * with the highest priority can be woken up without scanning all waiters.
+	 * Waiters with the same priority come out in the order they arrived.
+	 * They are linked through process->node
+	 */
+	struct heap waiters;
+
+	/**
+	 * The highest original priority among the processes that acquire this
+	 * resource in the script. Set by the framework while loading the script
+	 */
+	unsigned int ceiling;
+
+	/**
+	 * The resource id in the script. Scripts with ids spread over a large
+	 * range have their resources packed into the table, so the index in
+	 * @resources may differ from this. See __build_resources() in sched.c
+	 */
+	int id;
 };
 
 /**
- * This system has 16 different resources. It is defined in sched.c as an array of
- * struct resource (i.e., struct resource resources[NR_RESOURCES];)
+ * The resources in the system are defined in sched.c as an array of struct
+ * resource sized for the script (i.e., struct resource *resources; with
+ * @nr_resources entries). Callbacks get the index of a resource in the array
+ * as @resource_id.
  */
-#define NR_RESOURCES 16
 
 #endif
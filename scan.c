@@ -0,0 +1,240 @@
+/**********************************************************************
+ * Copyright (c) 2019-2021
+ *  Sang-Hoon Kim <sanghoonkim@ajou.ac.kr>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTIABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ **********************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#include "types.h"
+#include "scan.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define SCAN_AVX2
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#define SCAN_NEON
+#endif
+
+struct scan_kernels {
+	unsigned int (*find)(const unsigned int *v, unsigned int n, unsigned int value);
+	unsigned int (*argmax)(const unsigned int *v, unsigned int n);
+	void (*inc_sat)(unsigned int *v, unsigned int n, unsigned int max);
+};
+
+/***********************************************************************
+ * Plain C
+ ***********************************************************************/
+static unsigned int __find_scalar(const unsigned int *v, unsigned int n, unsigned int value)
+{
+	unsigned int i;
+
+	for (i = 0; i < n && v[i] != value; i++);
+	return i;
+}
+
+static unsigned int __argmax_scalar(const unsigned int *v, unsigned int n)
+{
+	unsigned int at = 0;
+
+	if (!n) return n;
+
+	for (unsigned int i = 1; i < n; i++) {
+		if (v[i] > v[at]) at = i;
+	}
+	return at;
+}
+
+static void __inc_sat_scalar(unsigned int *v, unsigned int n, unsigned int max)
+{
+	for (unsigned int i = 0; i < n; i++) {
+		if (v[i] < max) v[i]++;
+	}
+}
+
+static const struct scan_kernels __scalar_kernels = {
+	.find = __find_scalar,
+	.argmax = __argmax_scalar,
+	.inc_sat = __inc_sat_scalar,
+};
+
+
+#ifdef SCAN_AVX2
+/***********************************************************************
+ * AVX2, eight values at a time. Argmax finds the largest value first, and
+ * then its first position
+ ***********************************************************************/
+#define AVX2	__attribute__((target("avx2")))
+
+static inline AVX2 __m256i __load_avx2(const unsigned int *v)
+{
+	return _mm256_loadu_si256((const __m256i *)v);
+}
+
+static AVX2 unsigned int __find_avx2(const unsigned int *v, unsigned int n, unsigned int value)
+{
+	__m256i target = _mm256_set1_epi32(value);
+	unsigned int i;
+
+	for (i = 0; i + 8 <= n; i += 8) {
+		__m256i eq = _mm256_cmpeq_epi32(__load_avx2(v + i), target);
+		int mask = _mm256_movemask_ps(_mm256_castsi256_ps(eq));
+
+		if (mask) return i + __builtin_ctz(mask);
+	}
+	return i + __find_scalar(v + i, n - i, value);
+}
+
+static AVX2 unsigned int __argmax_avx2(const unsigned int *v, unsigned int n)
+{
+	unsigned int lanes[8], max, i;
+	__m256i acc;
+
+	if (n < 8) return __argmax_scalar(v, n);
+
+	acc = __load_avx2(v);
+	for (i = 8; i + 8 <= n; i += 8) {
+		acc = _mm256_max_epu32(acc, __load_avx2(v + i));
+	}
+	_mm256_storeu_si256((__m256i *)lanes, acc);
+
+	max = lanes[__argmax_scalar(lanes, 8)];
+	for (; i < n; i++) {
+		if (v[i] > max) max = v[i];
+	}
+	return __find_avx2(v, n, max);
+}
+
+static AVX2 void __inc_sat_avx2(unsigned int *v, unsigned int n, unsigned int max)
+{
+	__m256i one = _mm256_set1_epi32(1);
+	__m256i limit = _mm256_set1_epi32(max);
+	unsigned int i;
+
+	for (i = 0; i + 8 <= n; i += 8) {
+		__m256i x = _mm256_add_epi32(__load_avx2(v + i), one);
+		_mm256_storeu_si256((__m256i *)(v + i), _mm256_min_epu32(x, limit));
+	}
+	__inc_sat_scalar(v + i, n - i, max);
+}
+
+static const struct scan_kernels __simd_kernels = {
+	.find = __find_avx2,
+	.argmax = __argmax_avx2,
+	.inc_sat = __inc_sat_avx2,
+};
+
+static bool __simd_supported(void)
+{
+	return __builtin_cpu_supports("avx2") != 0;
+}
+#endif
+
+
+#ifdef SCAN_NEON
+/***********************************************************************
+ * NEON, four values at a time in the same way as AVX2
+ ***********************************************************************/
+static unsigned int __find_neon(const unsigned int *v, unsigned int n, unsigned int value)
+{
+	uint32x4_t target = vdupq_n_u32(value);
+	unsigned int i;
+
+	for (i = 0; i + 4 <= n; i += 4) {
+		if (vmaxvq_u32(vceqq_u32(vld1q_u32(v + i), target))) break;
+	}
+	return i + __find_scalar(v + i, n - i, value);
+}
+
+static unsigned int __argmax_neon(const unsigned int *v, unsigned int n)
+{
+	unsigned int max, i;
+	uint32x4_t acc;
+
+	if (n < 4) return __argmax_scalar(v, n);
+
+	acc = vld1q_u32(v);
+	for (i = 4; i + 4 <= n; i += 4) {
+		acc = vmaxq_u32(acc, vld1q_u32(v + i));
+	}
+	max = vmaxvq_u32(acc);
+	for (; i < n; i++) {
+		if (v[i] > max) max = v[i];
+	}
+	return __find_neon(v, n, max);
+}
+
+static void __inc_sat_neon(unsigned int *v, unsigned int n, unsigned int max)
+{
+	uint32x4_t one = vdupq_n_u32(1);
+	uint32x4_t limit = vdupq_n_u32(max);
+	unsigned int i;
+
+	for (i = 0; i + 4 <= n; i += 4) {
+		vst1q_u32(v + i, vminq_u32(vaddq_u32(vld1q_u32(v + i), one), limit));
+	}
+	__inc_sat_scalar(v + i, n - i, max);
+}
+
+static const struct scan_kernels __simd_kernels = {
+	.find = __find_neon,
+	.argmax = __argmax_neon,
+	.inc_sat = __inc_sat_neon,
+};
+
+static bool __simd_supported(void)
+{
+	return true;
+}
+#endif
+
+
+/**
+ * The kernels to use are picked once for all threads
+ */
+static const struct scan_kernels *__kernels = &__scalar_kernels;
+static pthread_once_t __kernels_once = PTHREAD_ONCE_INIT;
+
+static void __pick_kernels(void)
+{
+	const char *env = getenv("SCHED_SCAN");
+
+	if (env && strcmp(env, "scalar") == 0) return;
+
+#if defined(SCAN_AVX2) || defined(SCAN_NEON)
+	if (__simd_supported()) __kernels = &__simd_kernels;
+#endif
+}
+
+static inline const struct scan_kernels *__get_kernels(void)
+{
+	pthread_once(&__kernels_once, __pick_kernels);
+	return __kernels;
+}
+
+unsigned int scan_find(const unsigned int *v, unsigned int n, unsigned int value)
+{
+	return __get_kernels()->find(v, n, value);
+}
+
+unsigned int scan_argmax(const unsigned int *v, unsigned int n)
+{
+	return __get_kernels()->argmax(v, n);
+}
+
+void scan_inc_sat(unsigned int *v, unsigned int n, unsigned int max)
+{
+	__get_kernels()->inc_sat(v, n, max);
+}
@@ -0,0 +1,46 @@
+/**********************************************************************
+ * Copyright (c) 2019-2021
+ *  Sang-Hoon Kim <sanghoonkim@ajou.ac.kr>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTIABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ **********************************************************************/
+
+#ifndef __SCAN_H__
+#define __SCAN_H__
+
+/**
+ * Kernels scanning arrays of @n unsigned ints, for the schedulers that look
+ * at every candidate (see proc_table.h). They are vectorized with AVX2 or
+ * NEON where the CPU has them, and written in plain C otherwise. Set
+ * SCHED_SCAN=scalar in the environment to use the plain C ones anyway, e.g.,
+ * to compare the results.
+ *
+ * Where more than one element qualifies, the one at the lowest position is
+ * taken, so queues kept in arrays break ties in the FIFO order.
+ */
+
+/**
+ * scan_find - the first position of @value. @n if there is none
+ */
+unsigned int scan_find(const unsigned int *v, unsigned int n, unsigned int value);
+
+/**
+ * scan_argmax - the first position of the largest value. @n if @n is 0
+ */
+unsigned int scan_argmax(const unsigned int *v, unsigned int n);
+
+/**
+ * scan_inc_sat - increase each value by one up to @max. Values should not be
+ * larger than @max
+ */
+void scan_inc_sat(unsigned int *v, unsigned int n, unsigned int max);
+
+#endif
@@ -22,35 +22,61 @@
 #include <assert.h>
 #include <unistd.h>
 #include <getopt.h>
+#include <limits.h>
+#include <fcntl.h>
+#include <time.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 #include "types.h"
 #include "list_head.h"
+#include "heap.h"
+#include "bitmap.h"
+#include "pool.h"
+#include "proc_table.h"
+#include "workload.h"
+#include "checkpoint.h"
+#include "output.h"
+#include "trace.h"
+#include "metrics.h"
 
-#include "parser.h"
 #include "process.h"
 #include "resource.h"
 
 #include "sched.h"
 
+/**
+ * The state of a simulation is thread-local. The sweep mode (-x) runs the
+ * simulations in parallel, one in each thread. See __sweep()
+ */
+
 /**
  * List head to hold the processes ready to run
  */
-LIST_HEAD(readyqueue);
+__thread struct list_head readyqueue;
 
 /**
  * The process that is currently running
  */
-struct process *current = NULL;
+__thread struct process *current = NULL;
 
 /**
  * Number of generated ticks since the simulator was started
  */
-unsigned int ticks = 0;
+__thread unsigned int ticks = 0;
+
+/**
+ * Resources in the system. The table is sized for the script once it is
+ * loaded. See __build_resources()
+ */
+__thread struct resource *resources = NULL;
+__thread unsigned int nr_resources = 0;
 
 /**
- * Resources in the system.
+ * Resources owned or waited for. dump_status() visits only these
  */
-struct resource resources[NR_RESOURCES];
+static __thread unsigned long *__active_resources = NULL;
 
 /**
  * Following code is to maintain the simulator itself.
@@ -59,13 +85,101 @@ struct resource_schedule {
 	int resource_id;
 	int at;
 	int duration;
-	struct list_head list;
+	struct list_head list;		/* In process->__resources_to_acquire */
+	struct heap_node node;		/* In process->__resources_holding */
+
+	bool contended;				/* Failed to acquire at the first try */
+	unsigned int blocked_at;	/* When it failed to acquire at first */
+	unsigned int acquired_at;
 };
 
-static LIST_HEAD(__forkqueue);
+static __thread struct list_head __forkqueue;
+
+/**
+ * Processes and resource schedules are allocated from these pools, and
+ * released all together at the end of the simulation
+ */
+static __thread struct pool __process_pool;
+static __thread struct pool __resource_schedule_pool;
 
 bool quiet = false;
 
+/**
+ * Event-driven mode. Jump over ticks in which nothing but running @current
+ * or idling happens
+ */
+static bool event_driven = false;
+
+/**
+ * Do not put out the events. Simulations in a sweep only report the summary
+ */
+static bool mute = false;
+
+/**
+ * Do not render the events into the text output (-qq). They still go into
+ * the trace (-T) if asked for. Without the trace, the events are muted
+ */
+static bool headless = false;
+
+/**
+ * Print the scheduling metrics at the end (-M)
+ */
+static bool print_metrics = false;
+
+/**
+ * Collect the contention of the resources. Only for -M, and for -K to leave
+ * it to the simulation continued from the checkpoint
+ */
+static bool resource_stats = false;
+
+/**
+ * Time the simulation and the scheduler (-B). See bench.sh
+ */
+static bool bench = false;
+static __thread unsigned long __nr_schedules;
+static __thread unsigned long long __schedule_ns;
+
+/**
+ * Stop the simulation at @checkpoint_tick and save the state into
+ * @checkpointfile (-K). See checkpoint.h
+ */
+static char *checkpointfile = NULL;
+static unsigned int checkpoint_tick = 0;
+
+/**
+ * Write a snapshot of the simulation into @samplefile every @sample_period
+ * ticks (-I). See __take_sample()
+ */
+static FILE *samplefile = NULL;
+static unsigned int sample_period = 0;
+static unsigned int __next_sample = 0;
+
+/**
+ * Columns for each CPU in the output. A restored simulation (-R) keeps the
+ * layout of the one it was saved from
+ */
+static unsigned int cpu_width = 0;
+
+/**
+ * Simulated CPUs (-n). @current and @readyqueue are those of @this_cpu, and
+ * the ones of the other CPUs are parked in @__cpus until __switch_cpu()
+ * switches them in. The framework keeps CPU 0 switched in between ticks
+ */
+struct cpu {
+	struct process *current;
+	struct list_head readyqueue;
+	unsigned int busy_ticks;	/* # of ticks a process was on the CPU */
+};
+
+static __thread struct cpu __cpus[MAX_CPUS];
+static unsigned int nr_cpus = 1;
+__thread unsigned int this_cpu = 0;
+
+/**
+ * Move processes from the busiest CPU to the idlest one every this many ticks
+ */
+#define BALANCE_INTERVAL	4
+
 static const char * __process_status_sz[] = {
 	"RDY",
 	"RUN",
@@ -74,22 +188,69 @@ static const char * __process_status_sz[] = {
 };
 
 /**
- * Assorted schedulers
+ * Assorted schedulers. The specialized build (make sched-spec) has them in
+ * this file to inline them into the simulation. See __do_simulation()
+ */
+#ifdef SCHED_SPECIALIZED
+#include "pa2.c"
+#endif
+extern const struct scheduler fifo_scheduler;
+extern const struct scheduler sjf_scheduler;
+extern const struct scheduler srtf_scheduler;
+extern const struct scheduler rr_scheduler;
+extern const struct scheduler mlfq_scheduler;
+extern const struct scheduler prio_scheduler;
+extern const struct scheduler pa_scheduler;
+extern const struct scheduler pa_scan_scheduler;
+extern const struct scheduler pcp_scheduler;
+extern const struct scheduler pip_scheduler;
+extern const struct scheduler edf_scheduler;
+extern const struct scheduler rm_scheduler;
+
+/**
+ * Tunables of the schedulers
  */
-extern struct scheduler fifo_scheduler;
-extern struct scheduler sjf_scheduler;
-extern struct scheduler srtf_scheduler;
-extern struct scheduler rr_scheduler;
-extern struct scheduler prio_scheduler;
-extern struct scheduler pa_scheduler;
-extern struct scheduler pcp_scheduler;
-extern struct scheduler pip_scheduler;
+extern __thread unsigned int rr_quantum;
+extern __thread unsigned int pa_aging_period;
+
+static __thread const struct scheduler *sched = &fifo_scheduler;
+
+static struct {
+	char flag;
+	const struct scheduler *sched;
+} __schedulers[] = {
+	{ 'f', &fifo_scheduler },
+	{ 's', &sjf_scheduler },
+	{ 'S', &srtf_scheduler },
+	{ 'r', &rr_scheduler },
+	{ 'm', &mlfq_scheduler },
+	{ 'p', &prio_scheduler },
+	{ 'a', &pa_scheduler },
+	{ 'P', &pa_scan_scheduler },
+	{ 'c', &pcp_scheduler },
+	{ 'i', &pip_scheduler },
+	{ 'd', &edf_scheduler },
+	{ 't', &rm_scheduler },
+};
 
-static struct scheduler *sched = &fifo_scheduler;
+/**
+ * The scheduler selected with option @flag. NULL if none
+ */
+static const struct scheduler *__find_scheduler(char flag)
+{
+	for (int i = 0; i < sizeof(__schedulers) / sizeof(__schedulers[0]); i++) {
+		if (__schedulers[i].flag == flag) return __schedulers[i].sched;
+	}
+	return NULL;
+}
 
 void dump_status(void)
 {
 	struct process *p;
+	unsigned int i;
+
+	/* Put out the trace so far to see the status along with it */
+	output_flush();
 
 	printf("***** CURRENT *********\n");
 	if (current) {
@@ -107,334 +268,2789 @@ void dump_status(void)
 	}
 
 	printf("***** RESOURCES *******\n");
-	for (int i = 0; i < NR_RESOURCES; i++) {
-		struct resource *r = resources + i;;
-		if (r->owner || !list_empty(&r->waitqueue)) {
-			printf("%2d: owned by ", i);
-			if (r->owner) {
-				printf("%d\n", r->owner->pid);
-			} else {
-				printf("no one\n");
-			}
+	for_each_set_bit(i, __active_resources, nr_resources) {
+		struct resource *r = resources + i;
 
-			list_for_each_entry(p, &r->waitqueue, list) {
-				printf("    %d is waiting\n", p->pid);
-			}
+		printf("%2d: owned by ", r->id);
+		if (r->owner) {
+			printf("%d\n", r->owner->pid);
+		} else {
+			printf("no one\n");
+		}
+
+		list_for_each_entry(p, &r->waitqueue, list) {
+			printf("    %d is waiting\n", p->pid);
+		}
+		for (int j = 0; j < r->waiters.nr; j++) {
+			p = container_of(r->waiters.nodes[j], struct process, node);
+			printf("    %d is waiting\n", p->pid);
 		}
 	}
+	if (resource_stats) metrics_print_resources(ticks);
 	printf("\n\n");
 
 	return;
 }
 
-#define __print_event(pid, string, args...) do { \
-	fprintf(stderr, "%3d: ", ticks); \
-	for (int i = 0; i < pid; i++) { \
-		fprintf(stderr, "    "); \
-	} \
-	fprintf(stderr, string "\n", ##args); \
-} while (0);
+static void __switch_cpu(unsigned int cpu)
+{
+	struct cpu *c;
+
+	if (cpu == this_cpu) return;
+
+	c = __cpus + this_cpu;
+	c->current = current;
+	list_splice_init(&readyqueue, &c->readyqueue);
+
+	c = __cpus + cpu;
+	current = c->current;
+	list_splice_init(&c->readyqueue, &readyqueue);
+
+	this_cpu = cpu;
+}
+
+/**
+ * The functions on every tick, which are inlined into the simulation loop
+ * for each scheduler in the specialized build. See __do_simulation()
+ */
+#ifdef SCHED_SPECIALIZED
+#define __sim_inline	inline __attribute__((always_inline))
+#else
+#define __sim_inline
+#endif
+
+/**
+ * The framework puts processes into the ready queues with @sched, which the
+ * specialized simulations give as a constant. See __do_simulation()
+ */
+static __sim_inline void __enqueue_process(const struct scheduler *sched, struct process *p)
+{
+	unsigned int cpu = this_cpu;
+
+	/* Woken up after waiting for a resource since blocked */
+	if (p->__waiting_since) {
+		p->__waiting_ticks += ticks + 1 - p->__waiting_since;
+		p->__waiting_since = 0;
+	}
+
+	/* A resource release may wake up @p on another CPU */
+	__switch_cpu(p->cpu);
+
+	if (sched->enqueue) {
+		sched->enqueue(p);
+	} else {
+		list_add_tail(&p->list, &readyqueue);
+	}
+
+	__switch_cpu(cpu);
+}
+
+void enqueue_process(struct process *p)
+{
+	__enqueue_process(sched, p);
+}
+
+void dequeue_process(struct process *p)
+{
+	unsigned int cpu = this_cpu;
+
+	__switch_cpu(p->cpu);
 
-static inline bool strmatch(char * const str, const char *expect)
+	if (sched->dequeue) {
+		sched->dequeue(p);
+	} else {
+		list_del_init(&p->list);
+	}
+
+	__switch_cpu(cpu);
+}
+
+static inline void __print_event(enum trace_kind kind, unsigned int pid, int arg)
 {
-	return (strlen(str) == strlen(expect)) && (strncmp(str, expect, strlen(expect)) == 0);
+	struct trace_record r = {
+		.tick = ticks,
+		.pid = pid,
+		.kind = kind,
+		.cpu = this_cpu,
+		.arg = arg,
+	};
+
+	if (mute) return;
+
+	trace_emit(&r);
+	if (!headless) trace_render(&r);
 }
 
 static void __briefing_process(struct process *p)
 {
 	struct resource_schedule *rs;
 
-	if (quiet) return;
+	if (quiet || mute) return;
 
 	printf("- Process %d: Forked at tick %d and run for %d tick%s with initial priority %d\n",
 				p->pid, p->__starts_at, p->lifespan,
 				p->lifespan >= 2 ? "s" : "", p->prio);
+	if (p->deadline) {
+		printf("    Due %d tick%s after the fork", p->deadline, p->deadline >= 2 ? "s" : "");
+		if (p->period) printf(" every period of %d", p->period);
+		printf("\n");
+	}
 
 	list_for_each_entry(rs, &p->__resources_to_acquire, list) {
 		printf("    Acquire resource %d at %d for %d\n", rs->resource_id, rs->at, rs->duration);
 	}
 }
 
-static int __load_script(char * const filename)
+/**
+ * Put @p into the fork queue, which is sorted by the fork time. Scripts list
+ * processes mostly in the fork order, so look for the place from the tail.
+ * Processes to fork at the same tick stay in the script order
+ */
+static void __queue_fork(struct process *p)
 {
-	char line[256];
-	struct process *p = NULL;
-
-	FILE *file = fopen(filename, "r");
-	while (fgets(line, sizeof(line), file)) {
-		char *tokens[32] = { NULL };
-		int nr_tokens;
-
-		parse_command(line, &nr_tokens, tokens);
-
-		if (nr_tokens == 0) continue;
-
-		if (strmatch(tokens[0], "process")) {
-			assert(nr_tokens == 2);
-			/* Start processor description */
-			p = malloc(sizeof(*p));
-			memset(p, 0x00, sizeof(*p));
+	struct list_head *pos;
 
-			p->pid = atoi(tokens[1]);
-
-			INIT_LIST_HEAD(&p->list);
-			INIT_LIST_HEAD(&p->__resources_to_acquire);
-			INIT_LIST_HEAD(&p->__resources_holding);
-
-			continue;
-		} else if (strmatch(tokens[0], "end")) {
-			/* End of process description */
-			struct resource_schedule *rs;
-			assert(p);
-
-			list_add_tail(&p->list, &__forkqueue);
+	list_for_each_prev(pos, &__forkqueue) {
+		struct process *prev = list_entry(pos, struct process, list);
+		if (prev->__starts_at <= p->__starts_at) break;
+	}
+	list_add(&p->list, pos);
+}
 
-			__briefing_process(p);
-			p = NULL;
+/**
+ * Cursor over the script mapped in memory. Tokens point directly into the
+ * mapped buffer and are not NUL-terminated, so they come with their length
+ */
+struct __script_cursor {
+	const char *pos;
+	const char *end;
+};
 
-			continue;
-		}
+struct __script_token {
+	const char *str;
+	size_t len;
+};
 
-		if (strmatch(tokens[0], "lifespan")) {
-			assert(nr_tokens == 2);
-			p->lifespan = atoi(tokens[1]);
-		} else if (strmatch(tokens[0], "prio")) {
-			assert(nr_tokens == 2);
-			p->prio = p->prio_orig = atoi(tokens[1]);
-		} else if (strmatch(tokens[0], "start")) {
-			assert(nr_tokens == 2);
-			p->__starts_at = atoi(tokens[1]);
-		} else if (strmatch(tokens[0], "acquire")) {
-			struct resource_schedule *rs;
-			assert(nr_tokens == 4);
+static inline bool __is_blank(char c)
+{
+	return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+}
 
-			rs = malloc(sizeof(*rs));
+/**
+ * Get the next token in the current line. Return false at the end of the
+ * line, which includes the comment starting with '#'
+ */
+static bool __next_token(struct __script_cursor *c, struct __script_token *t)
+{
+	while (c->pos < c->end && __is_blank(*c->pos)) c->pos++;
 
-			rs->resource_id = atoi(tokens[1]);
-			rs->at = atoi(tokens[2]);
-			rs->duration = atoi(tokens[3]);
+	if (c->pos == c->end || *c->pos == '\n' || *c->pos == '#') return false;
 
-			list_add_tail(&rs->list, &p->__resources_to_acquire);
-		} else {
-			fprintf(stderr, "Unknown property %s\n", tokens[0]);
-			return false;
-		}
+	t->str = c->pos;
+	while (c->pos < c->end && *c->pos != '\n' && !__is_blank(*c->pos)) {
+		c->pos++;
 	}
-	fclose(file);
-	if (!quiet) printf("\n");
+	t->len = c->pos - t->str;
 	return true;
 }
 
-
 /**
- * Fork process on schedule
+ * Move to the beginning of the next line
  */
-static int __fork_on_schedule()
+static void __next_line(struct __script_cursor *c)
 {
-	int nr_forked = 0;
-	struct process *p, *tmp;
-	list_for_each_entry_safe(p, tmp, &__forkqueue, list) {
-		if (p->__starts_at <= ticks) {
-			list_move_tail(&p->list, &readyqueue);
-			p->status = PROCESS_READY;
-			__print_event(p->pid, "N");
-			if (sched->forked) sched->forked(p);
-			nr_forked++;
-		}
-	}
-	return nr_forked;
+	const char *eol = memchr(c->pos, '\n', c->end - c->pos);
+
+	c->pos = eol ? eol + 1 : c->end;
+}
+
+static inline bool __token_is(const struct __script_token *t, const char *keyword, size_t len)
+{
+	return t->len == len && memcmp(t->str, keyword, len) == 0;
 }
 
 /**
- * Exit the process
+ * Same as atoi() on the token
  */
-static void __exit_process(struct process *p)
+static int __token_to_int(const struct __script_token *t)
 {
-	/* Make sure the process is not attached to some list head */
-	assert(list_empty(&p->list));
+	const char *c = t->str, *end = t->str + t->len;
+	bool negative = false;
+	int value = 0;
 
-	/* Make sure the process is not holding any resource */
-	assert(list_empty(&p->__resources_holding));
+	if (c < end && (*c == '-' || *c == '+')) {
+		negative = (*c++ == '-');
+	}
+	for (; c < end && *c >= '0' && *c <= '9'; c++) {
+		value = value * 10 + (*c - '0');
+	}
+	return negative ? -value : value;
+}
 
-	/* Make sure there is no pending resource to acquire */
-	assert(list_empty(&p->__resources_to_acquire));
+#define KEYWORD(t, keyword)	__token_is(t, keyword, sizeof(keyword) - 1)
 
-	if (sched->exiting) sched->exiting(p);
+static struct process *__alloc_process(unsigned int pid)
+{
+	struct process *p = pool_alloc(&__process_pool);
+	memset(p, 0x00, sizeof(*p));
+
+	p->pid = pid;
 
-	__print_event(p->pid, "X");
+	INIT_LIST_HEAD(&p->list);
+	INIT_LIST_HEAD(&p->__resources_to_acquire);
+	heap_init(&p->__resources_holding);
+	INIT_LIST_HEAD(&p->resources_owned);
 
-	free(p);
+	return p;
 }
 
+static struct resource_schedule *__add_resource_schedule(struct process *p,
+		int resource_id, int at, int duration)
+{
+	struct resource_schedule *rs = pool_alloc(&__resource_schedule_pool);
+
+	rs->resource_id = resource_id;
+	rs->at = at;
+	rs->duration = duration;
+	rs->contended = false;
+
+	list_add_tail(&rs->list, &p->__resources_to_acquire);
+	return rs;
+}
 
 /**
- * Process resource acqutision
+ * Parse the line at @c, which describes *@p. Return 1 if the line ends the
+ * description, which leaves the process in *@p to the caller. Return 0 to go
+ * on with the next line, or -1 on error
  */
-static bool __run_current_acquire()
+static int __parse_line(struct __script_cursor *c, struct process **p)
 {
-	struct resource_schedule *rs, *tmp;
+	struct __script_token tokens[5];
+	int nr_tokens = 0;
+	struct __script_token t;
 
-	list_for_each_entry_safe(rs, tmp, &current->__resources_to_acquire, list) {
-		if (rs->at == current->age) {
-			assert(sched->acquire && "scheduler.acquire() not implemented");
+	while (__next_token(c, &t)) {
+		if (nr_tokens < sizeof(tokens) / sizeof(tokens[0])) {
+			tokens[nr_tokens] = t;
+		}
+		nr_tokens++;
+	}
 
-			/* Callback to acquire the resource */
-			if (sched->acquire(rs->resource_id)) {
-				list_move_tail(&rs->list, &current->__resources_holding);
+	if (nr_tokens == 0) return 0;
 
-				__print_event(current->pid, "+%d", rs->resource_id);
-			} else {
-				return false;
-			}
+	/* Dispatch on the first character of the keyword */
+	switch (tokens[0].str[0]) {
+	case 'p':
+		if (KEYWORD(tokens, "process")) {
+			assert(nr_tokens == 2);
+			/* Start processor description */
+			*p = __alloc_process(__token_to_int(tokens + 1));
+			return 0;
+		} else if (KEYWORD(tokens, "prio")) {
+			assert(nr_tokens == 2 && *p);
+			(*p)->prio = (*p)->prio_orig = __token_to_int(tokens + 1);
+			return 0;
+		} else if (KEYWORD(tokens, "period")) {
+			assert(nr_tokens == 2 && *p);
+			(*p)->period = __token_to_int(tokens + 1);
+			return 0;
 		}
+		break;
+	case 'd':
+		if (KEYWORD(tokens, "deadline")) {
+			assert(nr_tokens == 2 && *p);
+			(*p)->deadline = __token_to_int(tokens + 1);
+			return 0;
+		}
+		break;
+	case 'e':
+		if (KEYWORD(tokens, "end")) {
+			/* End of process description */
+			assert(*p);
+
+			/* Periodic processes are due by the end of the period */
+			if (!(*p)->deadline) (*p)->deadline = (*p)->period;
+			return 1;
+		}
+		break;
+	case 'l':
+		if (KEYWORD(tokens, "lifespan")) {
+			assert(nr_tokens == 2 && *p);
+			(*p)->lifespan = __token_to_int(tokens + 1);
+			return 0;
+		}
+		break;
+	case 's':
+		if (KEYWORD(tokens, "start")) {
+			assert(nr_tokens == 2 && *p);
+			(*p)->__starts_at = __token_to_int(tokens + 1);
+			return 0;
+		}
+		break;
+	case 'a':
+		if (KEYWORD(tokens, "acquire")) {
+			assert(nr_tokens == 4 && *p);
+
+			__add_resource_schedule(*p, __token_to_int(tokens + 1),
+					__token_to_int(tokens + 2), __token_to_int(tokens + 3));
+			return 0;
+		}
+		break;
 	}
 
-	return true;
+	fprintf(stderr, "Unknown property %.*s\n", (int)tokens[0].len, tokens[0].str);
+	return -1;
 }
 
 /**
- * Process resource release
+ * Parse the process description script in @script
  */
-static void __run_current_release()
+static bool __parse_script(const char *script, size_t size)
 {
-	struct resource_schedule *rs, *tmp;
+	struct process *p = NULL;
+	struct __script_cursor cursor = {
+		.pos = script,
+		.end = script + size,
+	};
+
+	for (; cursor.pos < cursor.end; __next_line(&cursor)) {
+		switch (__parse_line(&cursor, &p)) {
+		case -1:
+			return false;
+		case 1:
+			__queue_fork(p);
+
+			__briefing_process(p);
+			p = NULL;
+			break;
+		}
+	}
+	return true;
+}
 
-	list_for_each_entry_safe(rs, tmp, &current->__resources_holding, list) {
-		if (--rs->duration == 0) {
-			assert(sched->release && "scheduler.release() not implemented");
+static bool __load_workload(const char *workload, size_t size)
+{
+	const struct workload_header *header = (const void *)workload;
+	const struct workload_process *wp = (const void *)(header + 1);
+	const struct workload_acquire *wa = (const void *)(wp + header->nr_processes);
+
+	if (size != sizeof(*header) + sizeof(*wp) * header->nr_processes
+				+ sizeof(*wa) * header->nr_acquires) {
+		fprintf(stderr, "Corrupted workload\n");
+		return false;
+	}
 
-			/* Callback the release() */
-			sched->release(rs->resource_id);
+	for (unsigned int i = 0; i < header->nr_processes; i++, wp++) {
+		struct process *p = __alloc_process(wp->pid);
 
-			__print_event(current->pid, "-%d", rs->resource_id);
+		p->__starts_at = wp->start;
+		p->lifespan = wp->lifespan;
+		p->prio = p->prio_orig = wp->prio;
+		p->period = wp->period;
+		p->deadline = wp->deadline;
 
-			list_del(&rs->list);
-			free(rs);
+		if (wp->first_acquire + wp->nr_acquires > header->nr_acquires) {
+			fprintf(stderr, "Corrupted workload\n");
+			return false;
+		}
+		for (unsigned int j = 0; j < wp->nr_acquires; j++) {
+			const struct workload_acquire *a = wa + wp->first_acquire + j;
+			__add_resource_schedule(p, a->resource_id, a->at, a->duration);
 		}
+
+		/* Already sorted by the fork time, so it goes to the tail at once */
+		__queue_fork(p);
+
+		__briefing_process(p);
 	}
+	return true;
 }
 
-
-/***********************************************************************
- * The main loop for the scheduler simulation
+/**
+ * Set the ceiling of each resource to the highest priority of the processes
+ * that ever acquire it
  */
-static void __do_simulation(void)
+static void __set_ceilings(void)
 {
-	assert(sched->schedule && "scheduler.schedule() not implemented");
+	struct process *p;
+	struct resource_schedule *rs;
 
-	while (true) {
-		struct process *prev;
+	list_for_each_entry(p, &__forkqueue, list) {
+		list_for_each_entry(rs, &p->__resources_to_acquire, list) {
+			struct resource *r = resources + rs->resource_id;
 
-		/* Fork processes on schedule */
-		__fork_on_schedule();
+			if (p->prio_orig > r->ceiling) {
+				r->ceiling = p->prio_orig;
+			}
+		}
+	}
+}
 
-		/* Ask scheduler to pick the next process to run */
-		prev = current;
-		current = sched->schedule();
+/**
+ * Resource tables up to this many entries are indexed by the resource id
+ * even when few of the ids are in use
+ */
+#define DENSE_RESOURCES	4096
 
-		/* If the system ran a process in the previous tick, */
-		if (prev) {
-			/* Update the process status */
-			if (prev->status == PROCESS_RUNNING) {
-				prev->status = PROCESS_READY;
-			}
+/**
+ * Open addressing hash table from resource ids to the indices in @resources
+ */
+struct __resource_slot {
+	int id;					/* -1 if the slot is empty */
+	unsigned int index;
+};
 
-			/* Decommission it if completed */
-			if (prev->age == prev->lifespan) {
-				prev->status = PROCESS_EXIT;
-				__exit_process(prev);
-			}
-		}
+static struct __resource_slot *__resource_slot(struct __resource_slot *slots,
+		unsigned int mask, int id)
+{
+	unsigned int i = ((unsigned int)id * 2654435761U) & mask;
 
-		/* No process is ready to run at this moment */
-		if (!current) {
-			/* Quit simulation if no pending process exists */
-			if (list_empty(&readyqueue) && list_empty(&__forkqueue)) {
-				break;
-			}
+	while (slots[i].id >= 0 && slots[i].id != id) {
+		i = (i + 1) & mask;
+	}
+	return slots + i;
+}
 
-			/* Idle temporarily */
-			fprintf(stderr, "%3d: idle\n", ticks);
-		} else {
+static int __compare_ids(const void *a, const void *b)
+{
+	int x = *(const int *)a;
+	int y = *(const int *)b;
 
-			/* Execute the current process */
-			current->status = PROCESS_RUNNING;
+	return (x > y) - (x < y);
+}
 
-			/* Ensure that @current is detached from any list */
-			assert(list_empty(&current->list));
+/**
+ * Pack the resource ids of the @nr_acquires resource schedules into the
+ * indices from 0, keeping the order of the ids, and make the schedules refer
+ * to the resources with the indices. @ids gets the id at each index, which
+ * the caller frees. Return the # of distinct ids
+ */
+static unsigned int __pack_resource_ids(unsigned int nr_acquires, int **ids)
+{
+	unsigned int size = 1, nr_ids = 0;
+	struct __resource_slot *slots;
+	struct process *p;
+	struct resource_schedule *rs;
 
-			/* Try acquiring scheduled resources */
-			if (__run_current_acquire()) {
-				/* Succesfully acquired all the resources to make a progress! */
-				__print_event(current->pid, "%d", current->pid);
+	/* Keep the table at most half full */
+	while (size < nr_acquires * 2) size <<= 1;
 
-				/* So, it ages by one tick */
-				current->age++;
+	slots = malloc(sizeof(*slots) * size);
+	*ids = malloc(sizeof(**ids) * nr_acquires);
+	assert(slots && *ids);
 
-				/* And performs scheduled releases */
-				__run_current_release();
-			} else {
-				/**
-				 * The current is blocked while acquiring resource(s).
-				 * In this case, @current could not make a progress in this tick
-				 */
-				__print_event(current->pid, "=");
+	for (unsigned int i = 0; i < size; i++) {
+		slots[i].id = -1;
+	}
 
-				/* Thus, it is not get aged nor unable to perform releases */
+	list_for_each_entry(p, &__forkqueue, list) {
+		list_for_each_entry(rs, &p->__resources_to_acquire, list) {
+			struct __resource_slot *slot =
+					__resource_slot(slots, size - 1, rs->resource_id);
+
+			if (slot->id < 0) {
+				slot->id = rs->resource_id;
+				(*ids)[nr_ids++] = rs->resource_id;
 			}
 		}
+	}
 
-		/* Increase the tick counter */
-		ticks++;
+	qsort(*ids, nr_ids, sizeof(**ids), __compare_ids);
+	for (unsigned int i = 0; i < nr_ids; i++) {
+		__resource_slot(slots, size - 1, (*ids)[i])->index = i;
 	}
+
+	list_for_each_entry(p, &__forkqueue, list) {
+		list_for_each_entry(rs, &p->__resources_to_acquire, list) {
+			rs->resource_id = __resource_slot(slots, size - 1, rs->resource_id)->index;
+		}
+	}
+
+	free(slots);
+	return nr_ids;
 }
 
+/**
+ * Allocate the table of @nr resources. @ids is the id of each, or NULL if
+ * the ids are the indices
+ */
+static void __alloc_resources(unsigned int nr, const int *ids)
+{
+	nr_resources = nr;
+	resources = malloc(sizeof(*resources) * nr_resources);
+	__active_resources = calloc(BITS_TO_LONGS(nr_resources), sizeof(*__active_resources));
+	assert((resources && __active_resources) || !nr_resources);
+
+	for (unsigned int i = 0; i < nr_resources; i++) {
+		struct resource *r = resources + i;
+
+		r->owner = NULL;
+		INIT_LIST_HEAD(&r->owned);
+		INIT_LIST_HEAD(&r->waitqueue);
+		heap_init(&r->waiters);
+		r->ceiling = 0;
+		r->id = ids ? ids[i] : i;
+	}
 
-static void __initialize(void)
+	metrics_init_resources(nr_resources);
+}
+
+/**
+ * Build the resource table for the loaded processes. The table covers the
+ * ids up to the largest one in the script. When the ids are spread over a
+ * range larger than both DENSE_RESOURCES and the # of acquisitions, however,
+ * the table would be mostly of unused resources. Then the ids in use are
+ * packed into the table through a hash table, and resource->id tells the id
+ * of each. Either way, the simulation refers to a resource by its index
+ */
+static bool __build_resources(void)
 {
-	INIT_LIST_HEAD(&readyqueue);
+	struct process *p;
+	struct resource_schedule *rs;
+	unsigned int nr_acquires = 0;
+	int max_id = -1;
+	int *ids = NULL;
+
+	list_for_each_entry(p, &__forkqueue, list) {
+		list_for_each_entry(rs, &p->__resources_to_acquire, list) {
+			if (rs->resource_id < 0) {
+				fprintf(stderr, "Invalid resource %d for process %d\n",
+						rs->resource_id, p->pid);
+				return false;
+			}
+			if (rs->resource_id > max_id) max_id = rs->resource_id;
+			nr_acquires++;
+		}
+	}
 
-	for (int i = 0; i < NR_RESOURCES; i++) {
-		resources[i].owner = NULL;
-		INIT_LIST_HEAD(&(resources[i].waitqueue));
+	if (max_id >= DENSE_RESOURCES && max_id >= nr_acquires) {
+		unsigned int nr_ids = __pack_resource_ids(nr_acquires, &ids);
+		__alloc_resources(nr_ids, ids);
+	} else {
+		__alloc_resources(max_id + 1, NULL);
 	}
+	free(ids);
+
+	__set_ceilings();
+	return true;
+}
+
+/**
+ * Mark whether the resource @resource_id is in @__active_resources
+ */
+static void __update_active_resource(int resource_id)
+{
+	struct resource *r = resources + resource_id;
+
+	if (r->owner || !list_empty(&r->waitqueue) || !heap_empty(&r->waiters)) {
+		set_bit(__active_resources, resource_id);
+	} else {
+		clear_bit(__active_resources, resource_id);
+	}
+}
+
+/**
+ * Read the processes in @filename, which is a script or a binary workload,
+ * into @__forkqueue. The resource ids are not resolved yet
+ */
+static bool __read_script(char * const filename)
+{
+	struct stat st;
+	char *script = NULL;
+	bool loaded;
+
+	int fd = open(filename, O_RDONLY);
+	if (fd < 0 || fstat(fd, &st)) {
+		fprintf(stderr, "Unable to open %s\n", filename);
+		if (fd >= 0) close(fd);
+		return false;
+	}
+
+	/* Nothing to map for an empty script */
+	if (st.st_size) {
+		script = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (script == MAP_FAILED) {
+			fprintf(stderr, "Unable to map %s\n", filename);
+			close(fd);
+			return false;
+		}
+		posix_madvise(script, st.st_size, POSIX_MADV_SEQUENTIAL);
+	}
+	close(fd);
+
+	if (st.st_size >= sizeof(struct workload_header) &&
+			memcmp(script, WORKLOAD_MAGIC, WORKLOAD_MAGIC_LEN) == 0) {
+		loaded = __load_workload(script, st.st_size);
+	} else {
+		loaded = __parse_script(script, st.st_size);
+	}
+
+	if (script) munmap(script, st.st_size);
+	return loaded;
+}
+
+static int __load_script(char * const filename)
+{
+	bool loaded = __read_script(filename);
+
+	if (loaded) loaded = __build_resources();
+	if (loaded && !quiet) printf("\n");
+	return loaded;
+}
+
+/**
+ * Give each CPU as many columns in the output as the largest pid needs
+ */
+static void __layout_cpus(void)
+{
+	struct process *p;
+
+	list_for_each_entry(p, &__forkqueue, list) {
+		if (p->pid + 1 > cpu_width) cpu_width = p->pid + 1;
+	}
+	trace_set_cpu_width(cpu_width);
+}
+
+/***********************************************************************
+ * Streaming mode (-F)
+ *
+ * Read the processes while simulating instead of loading all of them in
+ * advance, which needs the processes sorted by the start as in the binary
+ * workloads. The fork queue holds the processes to fork by the current tick
+ * and one more, which tells when the next fork is. Processes are released
+ * when they exit, so the memory is for the live processes only.
+ *
+ * The resource table and the ceilings, however, should be of all the
+ * processes ever acquiring the resources. So a pass over the script before
+ * the simulation collects the resource ids, keeping one process at a time.
+ */
+static bool streaming = false;
+
+struct __stream {
+	FILE *file;
+	bool workload;				/* Binary workload. Script otherwise */
+	bool eof;
+	bool failed;
+
+	/* Script */
+	char *line;
+	size_t line_size;
+	struct process *p;			/* Process being described */
+
+	/* Binary workload */
+	FILE *acquires;				/* At the acquires of the next process */
+	unsigned int nr_processes;	/* # of processes left */
+	unsigned int nr_acquires;	/* # of acquires read so far */
+
+	/* Index of each resource id. NULL if the ids are the indices */
+	struct __resource_slot *slots;
+	unsigned int mask;
+};
+
+static struct __stream __stream;
+
+static bool __open_stream(struct __stream *s, char * const filename)
+{
+	struct workload_header header;
+
+	memset(s, 0x00, sizeof(*s));
+
+	s->file = fopen(filename, "rb");
+	if (!s->file) {
+		fprintf(stderr, "Unable to open %s\n", filename);
+		return false;
+	}
+
+	if (fread(&header, sizeof(header), 1, s->file) == 1 &&
+			memcmp(header.magic, WORKLOAD_MAGIC, WORKLOAD_MAGIC_LEN) == 0) {
+		s->workload = true;
+		s->nr_processes = header.nr_processes;
+
+		/* The acquires follow the processes. Read them along */
+		s->acquires = fopen(filename, "rb");
+		if (!s->acquires || fseeko(s->acquires, sizeof(header) +
+				(off_t)sizeof(struct workload_process) * header.nr_processes,
+				SEEK_SET)) {
+			fprintf(stderr, "Unable to open %s\n", filename);
+			return false;
+		}
+	} else {
+		rewind(s->file);
+	}
+	return true;
+}
+
+static void __close_stream(struct __stream *s)
+{
+	if (s->file) fclose(s->file);
+	if (s->acquires) fclose(s->acquires);
+	free(s->line);
+	free(s->slots);
+	s->file = s->acquires = NULL;
+	s->line = NULL;
+	s->slots = NULL;
+}
+
+static struct process *__read_workload_process(struct __stream *s)
+{
+	struct workload_process wp;
+	struct workload_acquire wa;
+	struct process *p;
+
+	if (!s->nr_processes) {
+		s->eof = true;
+		return NULL;
+	}
+
+	if (fread(&wp, sizeof(wp), 1, s->file) != 1 ||
+			wp.first_acquire != s->nr_acquires) {
+		goto corrupted;
+	}
+
+	p = __alloc_process(wp.pid);
+	p->__starts_at = wp.start;
+	p->lifespan = wp.lifespan;
+	p->prio = p->prio_orig = wp.prio;
+	p->period = wp.period;
+	p->deadline = wp.deadline;
+
+	for (unsigned int i = 0; i < wp.nr_acquires; i++) {
+		if (fread(&wa, sizeof(wa), 1, s->acquires) != 1) goto corrupted;
+		__add_resource_schedule(p, wa.resource_id, wa.at, wa.duration);
+	}
+
+	s->nr_processes--;
+	s->nr_acquires += wp.nr_acquires;
+	return p;
+
+corrupted:
+	fprintf(stderr, "Corrupted workload\n");
+	s->failed = true;
+	return NULL;
+}
+
+/**
+ * Read the next process from @s. NULL at the end of @s or on error, which
+ * sets @s->failed
+ */
+static struct process *__read_process(struct __stream *s)
+{
+	ssize_t len;
+
+	if (s->eof || s->failed) return NULL;
+
+	if (s->workload) return __read_workload_process(s);
+
+	while ((len = getline(&s->line, &s->line_size, s->file)) >= 0) {
+		struct __script_cursor cursor = {
+			.pos = s->line,
+			.end = s->line + len,
+		};
+		struct process *p;
+
+		switch (__parse_line(&cursor, &s->p)) {
+		case -1:
+			s->failed = true;
+			return NULL;
+		case 1:
+			p = s->p;
+			s->p = NULL;
+			return p;
+		}
+	}
+
+	s->eof = true;
+	return NULL;
+}
+
+/**
+ * Release @p that has not been forked
+ */
+static void __free_process(struct process *p)
+{
+	struct resource_schedule *rs, *tmp;
+
+	list_for_each_entry_safe(rs, tmp, &p->__resources_to_acquire, list) {
+		pool_free(&__resource_schedule_pool, rs);
+	}
+	heap_destroy(&p->__resources_holding);
+	pool_free(&__process_pool, p);
+}
+
+/**
+ * Resource ids found in the pass over the stream, in the order found
+ */
+struct __stream_ids {
+	struct __resource_slot *slots;
+	unsigned int size;			/* # of @slots, a power of 2 */
+	unsigned int nr;
+	int *ids;
+	unsigned int *ceilings;		/* The highest prio_orig acquiring each */
+};
+
+static void __add_stream_id(struct __stream_ids *t, int id, unsigned int prio)
+{
+	struct __resource_slot *slot;
+
+	/* Keep the table at most half full */
+	if (t->nr * 2 >= t->size) {
+		t->size = t->size ? t->size * 2 : 64;
+		free(t->slots);
+		t->slots = malloc(sizeof(*t->slots) * t->size);
+		t->ids = realloc(t->ids, sizeof(*t->ids) * t->size / 2);
+		t->ceilings = realloc(t->ceilings, sizeof(*t->ceilings) * t->size / 2);
+		assert(t->slots && t->ids && t->ceilings);
+
+		for (unsigned int i = 0; i < t->size; i++) {
+			t->slots[i].id = -1;
+		}
+		for (unsigned int i = 0; i < t->nr; i++) {
+			slot = __resource_slot(t->slots, t->size - 1, t->ids[i]);
+			slot->id = t->ids[i];
+			slot->index = i;
+		}
+	}
+
+	slot = __resource_slot(t->slots, t->size - 1, id);
+	if (slot->id < 0) {
+		slot->id = id;
+		slot->index = t->nr;
+		t->ids[t->nr] = id;
+		t->ceilings[t->nr++] = prio;
+	} else if (prio > t->ceilings[slot->index]) {
+		t->ceilings[slot->index] = prio;
+	}
+}
+
+/**
+ * Go over the processes in @filename to build the resource table and to lay
+ * out the output, and open @filename again to stream the processes during
+ * the simulation. Same as __build_resources(), the table is indexed by the
+ * ids unless they are too sparse
+ */
+static bool __load_stream(char * const filename)
+{
+	struct __stream_ids t = {
+		.slots = NULL,
+	};
+	struct process *p;
+	struct resource_schedule *rs;
+	unsigned int last_start = 0;
+	unsigned long nr_acquires = 0;
+	int max_id = -1;
+	bool loaded = false;
+
+	if (!__open_stream(&__stream, filename)) goto out;
+
+	while ((p = __read_process(&__stream))) {
+		if (p->__starts_at < last_start) {
+			fprintf(stderr, "Process %d starts before the previous one. "
+					"Sort the processes by the start to stream them\n", p->pid);
+			goto out;
+		}
+		last_start = p->__starts_at;
+
+		if (p->pid + 1 > cpu_width) cpu_width = p->pid + 1;
+
+		list_for_each_entry(rs, &p->__resources_to_acquire, list) {
+			if (rs->resource_id < 0) {
+				fprintf(stderr, "Invalid resource %d for process %d\n",
+						rs->resource_id, p->pid);
+				goto out;
+			}
+			if (rs->resource_id > max_id) max_id = rs->resource_id;
+			__add_stream_id(&t, rs->resource_id, p->prio_orig);
+			nr_acquires++;
+		}
+
+		__briefing_process(p);
+		__free_process(p);
+	}
+	if (__stream.failed) goto out;
+
+	if (max_id >= DENSE_RESOURCES && max_id >= nr_acquires) {
+		int *ids = malloc(sizeof(*ids) * t.nr);
+
+		assert(ids);
+		memcpy(ids, t.ids, sizeof(*ids) * t.nr);
+		qsort(ids, t.nr, sizeof(*ids), __compare_ids);
+		__alloc_resources(t.nr, ids);
+
+		/* The table now maps the ids to the indices in @resources */
+		for (unsigned int i = 0; i < t.nr; i++) {
+			struct __resource_slot *slot =
+					__resource_slot(t.slots, t.size - 1, ids[i]);
+
+			resources[i].ceiling = t.ceilings[slot->index];
+			slot->index = i;
+		}
+		free(ids);
+	} else {
+		__alloc_resources(max_id + 1, NULL);
+
+		for (unsigned int i = 0; i < t.nr; i++) {
+			resources[t.ids[i]].ceiling = t.ceilings[i];
+		}
+	}
+
+	__close_stream(&__stream);
+	if (!__open_stream(&__stream, filename)) goto out;
+
+	if (max_id >= DENSE_RESOURCES && max_id >= nr_acquires) {
+		__stream.slots = t.slots;
+		__stream.mask = t.size - 1;
+		t.slots = NULL;
+	}
+
+	if (!quiet) printf("\n");
+	loaded = true;
+
+out:
+	free(t.slots);
+	free(t.ids);
+	free(t.ceilings);
+	return loaded;
+}
+
+/**
+ * Read ahead the processes to fork by this tick, and the one after them
+ */
+static bool __stream_forks(void)
+{
+	while (list_empty(&__forkqueue) ||
+			list_last_entry(&__forkqueue, struct process, list)->__starts_at <= ticks) {
+		struct process *p = __read_process(&__stream);
+		struct resource_schedule *rs;
+
+		if (!p) return !__stream.failed;
+
+		if (__stream.slots) {
+			list_for_each_entry(rs, &p->__resources_to_acquire, list) {
+				rs->resource_id = __resource_slot(__stream.slots, __stream.mask,
+						rs->resource_id)->index;
+			}
+		}
+		list_add_tail(&p->list, &__forkqueue);
+	}
+	return true;
+}
+
+/**
+ * Put the loaded processes in the binary workload format. The caller frees
+ * the returned buffer of @size bytes
+ */
+static char *__build_workload(size_t *size)
+{
+	struct workload_header *header;
+	struct workload_process *wp;
+	struct workload_acquire *wa;
+	unsigned int nr_processes = 0, nr_acquires = 0;
+	struct process *p;
+	struct resource_schedule *rs;
+	char *workload;
+
+	list_for_each_entry(p, &__forkqueue, list) {
+		nr_processes++;
+		list_for_each_entry(rs, &p->__resources_to_acquire, list) {
+			nr_acquires++;
+		}
+	}
+
+	*size = sizeof(*header) + sizeof(*wp) * nr_processes
+			+ sizeof(*wa) * nr_acquires;
+	workload = malloc(*size);
+	assert(workload);
+
+	header = (void *)workload;
+	memcpy(header->magic, WORKLOAD_MAGIC, WORKLOAD_MAGIC_LEN);
+	header->nr_processes = nr_processes;
+	header->nr_acquires = nr_acquires;
+
+	wp = (void *)(header + 1);
+	wa = (void *)(wp + nr_processes);
+
+	/* @__forkqueue is in the order to fork, which the format requires */
+	nr_acquires = 0;
+	list_for_each_entry(p, &__forkqueue, list) {
+		*wp = (struct workload_process) {
+			.pid = p->pid,
+			.start = p->__starts_at,
+			.lifespan = p->lifespan,
+			.prio = p->prio_orig,
+			.period = p->period,
+			.deadline = p->deadline,
+			.first_acquire = nr_acquires,
+		};
+		list_for_each_entry(rs, &p->__resources_to_acquire, list) {
+			*wa++ = (struct workload_acquire) {
+				.resource_id = resources[rs->resource_id].id,
+				.at = rs->at,
+				.duration = rs->duration,
+			};
+			wp->nr_acquires++;
+		}
+		nr_acquires += wp->nr_acquires;
+		wp++;
+	}
+	return workload;
+}
+
+/**
+ * Write the loaded processes into @filename in the binary workload format
+ */
+static bool __save_workload(char * const filename)
+{
+	size_t size;
+	char *workload = __build_workload(&size);
+	FILE *file;
+	bool written = false;
+
+	file = fopen(filename, "wb");
+	if (!file) {
+		fprintf(stderr, "Unable to open %s\n", filename);
+		goto out;
+	}
+
+	fwrite(workload, size, 1, file);
+
+	if (fclose(file)) {
+		fprintf(stderr, "Unable to write %s\n", filename);
+		goto out;
+	}
+	written = true;
+
+out:
+	free(workload);
+	return written;
+}
+
+
+/**
+ * # of processes ready to run on @this_cpu
+ */
+static __sim_inline unsigned int __nr_ready(const struct scheduler *sched)
+{
+	unsigned int nr_ready = 0;
+	struct list_head *l;
+
+	if (sched->nr_ready) return sched->nr_ready();
+
+	list_for_each(l, &readyqueue) {
+		nr_ready++;
+	}
+	return nr_ready;
+}
+
+/**
+ * # of processes on @cpu including the one running on it
+ */
+static unsigned int __cpu_load(const struct scheduler *sched, unsigned int cpu)
+{
+	unsigned int load;
+
+	__switch_cpu(cpu);
+	load = __nr_ready(sched) + (current ? 1 : 0);
+	__switch_cpu(0);
+
+	return load;
+}
+
+static unsigned int __idlest_cpu(const struct scheduler *sched)
+{
+	unsigned int idlest = 0, min_load = UINT_MAX;
+
+	for (unsigned int cpu = 0; cpu < nr_cpus; cpu++) {
+		unsigned int load = __cpu_load(sched, cpu);
+		if (load < min_load) {
+			idlest = cpu;
+			min_load = load;
+		}
+	}
+	return idlest;
+}
+
+/**
+ * Take a ready process out of @victim to run it on @this_cpu
+ */
+static bool __migrate_from(const struct scheduler *sched, unsigned int victim)
+{
+	unsigned int cpu = this_cpu;
+	struct process *p = NULL;
+
+	__switch_cpu(victim);
+	if (sched->steal) {
+		p = sched->steal();
+	} else if (!sched->enqueue && !list_empty(&readyqueue)) {
+		p = list_first_entry(&readyqueue, struct process, list);
+		list_del_init(&p->list);
+	}
+	__switch_cpu(cpu);
+
+	if (!p) return false;
+
+	p->cpu = cpu;
+	__enqueue_process(sched, p);
+	return true;
+}
+
+/**
+ * Let @this_cpu, which is about to run out of processes, steal one from the
+ * CPU with the most ready processes
+ */
+static void __steal_process(const struct scheduler *sched)
+{
+	unsigned int cpu = this_cpu;
+	unsigned int busiest = cpu, max_ready = 0;
+
+	for (unsigned int i = 0; i < nr_cpus; i++) {
+		unsigned int nr_ready;
+
+		if (i == cpu) continue;
+
+		__switch_cpu(i);
+		nr_ready = __nr_ready(sched);
+		if (nr_ready > max_ready) {
+			busiest = i;
+			max_ready = nr_ready;
+		}
+	}
+	__switch_cpu(cpu);
+
+	if (busiest != cpu) {
+		__migrate_from(sched, busiest);
+	}
+}
+
+/**
+ * Push ready processes from the busiest CPU to the idlest one until the loads
+ * of them differ by at most one
+ */
+static void __balance_load(const struct scheduler *sched)
+{
+	while (true) {
+		unsigned int busiest = 0, idlest = 0;
+		unsigned int max_load = 0, min_load = UINT_MAX;
+
+		for (unsigned int cpu = 0; cpu < nr_cpus; cpu++) {
+			unsigned int load = __cpu_load(sched, cpu);
+			if (load > max_load) {
+				busiest = cpu;
+				max_load = load;
+			}
+			if (load < min_load) {
+				idlest = cpu;
+				min_load = load;
+			}
+		}
+		if (max_load - min_load < 2) break;
+
+		__switch_cpu(idlest);
+		if (!__migrate_from(sched, busiest)) break;
+		__switch_cpu(0);
+	}
+	__switch_cpu(0);
+}
+
+/**
+ * Sort the resource schedules of @p by the age to acquire, so that the ones
+ * to acquire next are always at the head. Like the fork queue, scripts list
+ * them mostly in that order, so each finds its place from the tail of the
+ * sorted ones. The ones to acquire at the same age stay in the script order
+ */
+static void __sort_resource_schedules(struct process *p)
+{
+	struct resource_schedule *rs, *tmp;
+	LIST_HEAD(sorted);
+
+	list_for_each_entry_safe(rs, tmp, &p->__resources_to_acquire, list) {
+		struct list_head *pos;
+
+		list_for_each_prev(pos, &sorted) {
+			struct resource_schedule *prev =
+					list_entry(pos, struct resource_schedule, list);
+			if (prev->at <= rs->at) break;
+		}
+		list_move(&rs->list, pos);
+	}
+	list_splice(&sorted, &p->__resources_to_acquire);
+}
+
+/**
+ * Fork process on schedule
+ */
+static __sim_inline int __fork_on_schedule(const struct scheduler *sched)
+{
+	int nr_forked = 0;
+
+	/* @__forkqueue is sorted by the fork time. See __queue_fork() */
+	while (!list_empty(&__forkqueue)) {
+		struct process *p =
+				list_first_entry(&__forkqueue, struct process, list);
+
+		if (p->__starts_at > ticks) break;
+
+		list_del_init(&p->list);
+
+		/* Start the process on the CPU with the fewest processes */
+		if (nr_cpus > 1) {
+			__switch_cpu(__idlest_cpu(sched));
+		}
+		p->cpu = this_cpu;
+
+		p->deadline_at = p->deadline ? ticks + p->deadline : UINT_MAX;
+
+		if (sched->admit && !sched->admit(p)) {
+			__print_event(TRACE_REJECT, p->pid, 0);
+			metrics_deadline_rejected();
+			__free_process(p);
+
+			__switch_cpu(0);
+			continue;
+		}
+
+		p->__forked_at = ticks;
+		p->__first_run_at = UINT_MAX;
+
+		__sort_resource_schedules(p);
+		proc_slot_alloc(p);
+
+		p->status = PROCESS_READY;
+		__enqueue_process(sched, p);
+		__print_event(TRACE_FORK, p->pid, 0);
+		if (sched->forked) sched->forked(p);
+		nr_forked++;
+
+		__switch_cpu(0);
+	}
+	return nr_forked;
+}
+
+static void __record_metrics(struct process *p)
+{
+	unsigned int values[NR_METRICS] = {
+		[METRIC_TURNAROUND] = ticks - p->__forked_at,
+		[METRIC_BLOCKED] = p->__blocked_ticks,
+		[METRIC_WAITING] = p->__waiting_ticks,
+	};
+
+	/* One that never ran waited for a processor until its exit */
+	if (p->__first_run_at == UINT_MAX) {
+		values[METRIC_RESPONSE] = values[METRIC_TURNAROUND];
+	} else {
+		values[METRIC_RESPONSE] = p->__first_run_at - p->__forked_at;
+	}
+
+	/* It was ready to run when neither running, blocked, nor waiting */
+	values[METRIC_READY] = values[METRIC_TURNAROUND] - p->lifespan
+			- p->__blocked_ticks - p->__waiting_ticks;
+
+	metrics_record(values);
+
+	if (p->deadline_at != UINT_MAX) metrics_deadline(p->deadline_at, ticks);
+}
+
+/**
+ * Exit the process
+ */
+static __sim_inline void __exit_process(const struct scheduler *sched, struct process *p)
+{
+	/* Make sure the process is not attached to some list head */
+	assert(list_empty(&p->list));
+
+	/* Make sure the process is not holding any resource */
+	assert(heap_empty(&p->__resources_holding));
+	heap_destroy(&p->__resources_holding);
+
+	/* Make sure there is no pending resource to acquire */
+	assert(list_empty(&p->__resources_to_acquire));
+
+	if (sched->exiting) sched->exiting(p);
+
+	__print_event(TRACE_EXIT, p->pid, 0);
+
+	/* The samples would grow with the stream unless asked for */
+	if (!streaming || print_metrics) __record_metrics(p);
+
+	proc_slot_free(p);
+	pool_free(&__process_pool, p);
+}
+
+
+/**
+ * Process resource acqutision
+ */
+static __sim_inline bool __run_current_acquire(const struct scheduler *sched)
+{
+	struct resource_schedule *rs, *tmp;
+
+	/* Sorted by @at, so the ones to acquire now are at the head */
+	list_for_each_entry_safe(rs, tmp, &current->__resources_to_acquire, list) {
+		if (rs->at != current->age) break;
+
+		assert(sched->acquire && "scheduler.acquire() not implemented");
+
+		/* Callback to acquire the resource */
+		if (sched->acquire(rs->resource_id)) {
+			__update_active_resource(rs->resource_id);
+
+			/* Held for @rs->duration ticks of running from now on */
+			list_del_init(&rs->list);
+			heap_push(&current->__resources_holding, &rs->node,
+					rs->at + rs->duration);
+
+			__print_event(TRACE_ACQUIRE, current->pid,
+					resources[rs->resource_id].id);
+
+			rs->acquired_at = ticks;
+			if (resource_stats) {
+				metrics_resource_acquired(rs->resource_id, current->prio_orig,
+						ticks, rs->contended, ticks - rs->blocked_at);
+			}
+		} else {
+			__update_active_resource(rs->resource_id);
+			if (!rs->contended) {
+				rs->contended = true;
+				rs->blocked_at = ticks;
+				if (resource_stats) {
+					metrics_resource_blocked(rs->resource_id,
+							current->prio_orig, ticks);
+				}
+			}
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/**
+ * Process resource release
+ */
+static __sim_inline void __run_current_release(const struct scheduler *sched)
+{
+	struct heap_node *node;
+
+	/* Ones to release at the same age come out in the order acquired */
+	while ((node = heap_peek(&current->__resources_holding)) &&
+			node->key <= current->age) {
+		struct resource_schedule *rs =
+				container_of(node, struct resource_schedule, node);
+
+		heap_pop(&current->__resources_holding);
+
+		assert(sched->release && "scheduler.release() not implemented");
+
+		/* Callback the release() */
+		sched->release(rs->resource_id);
+		__update_active_resource(rs->resource_id);
+
+		__print_event(TRACE_RELEASE, current->pid,
+				resources[rs->resource_id].id);
+
+		if (resource_stats) {
+			metrics_resource_released(rs->resource_id, ticks,
+					ticks - rs->acquired_at + 1);
+		}
+
+		pool_free(&__resource_schedule_pool, rs);
+	}
+}
+
+
+/**
+ * # of upcoming ticks in which nothing happens but @current making progress
+ * or the system being idle. The framework can go over them without calling
+ * the scheduler.
+ */
+static __sim_inline unsigned int __ticks_to_next_event(const struct scheduler *sched)
+{
+	unsigned int nr_ticks = UINT_MAX;
+	struct process *p;
+	struct resource_schedule *rs;
+	struct heap_node *node;
+
+	if (!sched->timeslice) return 0;
+
+	/* The next fork, which is at the head of the sorted @__forkqueue */
+	if (!list_empty(&__forkqueue)) {
+		p = list_first_entry(&__forkqueue, struct process, list);
+		nr_ticks = p->__starts_at - ticks;
+	}
+
+	if (!current) {
+		/* Nothing can wake up while idling. Wait for the next fork */
+		if (!list_empty(&readyqueue)) return 0;
+		return nr_ticks;
+	}
+
+	/* @current should leave the processor or has something to do */
+	if (current->status != PROCESS_RUNNING || !list_empty(&current->list)) {
+		return 0;
+	}
+
+	/* Completion */
+	if (current->lifespan - current->age < nr_ticks) {
+		nr_ticks = current->lifespan - current->age;
+	}
+
+	/* The next acquisition, at the head of the sorted schedules */
+	if (!list_empty(&current->__resources_to_acquire)) {
+		rs = list_first_entry(&current->__resources_to_acquire,
+				struct resource_schedule, list);
+		if (rs->at >= current->age && rs->at - current->age < nr_ticks) {
+			nr_ticks = rs->at - current->age;
+		}
+	}
+
+	/* The next release, at the top of the heap */
+	node = heap_peek(&current->__resources_holding);
+	if (node && node->key - current->age - 1 < nr_ticks) {
+		nr_ticks = node->key - current->age - 1;
+	}
+
+	/* The scheduler may want to preempt @current */
+	if (nr_ticks) {
+		unsigned int timeslice = sched->timeslice();
+		if (timeslice < nr_ticks) {
+			nr_ticks = timeslice;
+		}
+	}
+
+	return nr_ticks;
+}
+
+/**
+ * Go through the ticks to the next event at once
+ */
+static __sim_inline void __skip_to_next_event(const struct scheduler *sched)
+{
+	unsigned int nr_ticks = __ticks_to_next_event(sched);
+
+	/* Stop at the checkpoint and the samples */
+	if (checkpointfile && checkpoint_tick - ticks < nr_ticks) {
+		nr_ticks = checkpoint_tick - ticks;
+	}
+	if (sample_period && __next_sample - ticks < nr_ticks) {
+		nr_ticks = __next_sample - ticks;
+	}
+
+	if (!nr_ticks) return;
+
+	if (current) {
+		__cpus[this_cpu].busy_ticks += nr_ticks;
+		current->age += nr_ticks;
+	}
+
+	/* Nothing to put out for each tick, neither to the screen nor the trace */
+	if (mute) {
+		ticks += nr_ticks;
+		return;
+	}
+
+	for (unsigned int i = 0; i < nr_ticks; i++, ticks++) {
+		if (current) {
+			__print_event(TRACE_RUN, current->pid, 0);
+		} else {
+			__print_event(TRACE_IDLE, 0, 0);
+		}
+	}
+}
+
+
+static inline unsigned long long __now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+/**
+ * Ask the scheduler of @this_cpu to pick the next process to run, and
+ * retire the process that ran on it in the previous tick
+ */
+static __sim_inline void __schedule_cpu(const struct scheduler *sched)
+{
+	struct process *prev;
+
+	/* Steal a process from another CPU if this CPU will be out of work */
+	if (nr_cpus > 1 && !__nr_ready(sched) &&
+			(!current || current->status == PROCESS_WAIT ||
+			 current->age == current->lifespan)) {
+		__steal_process(sched);
+	}
+
+	/* Ask scheduler to pick the next process to run */
+	prev = current;
+	if (bench) {
+		unsigned long long start = __now_ns();
+		current = sched->schedule();
+		__schedule_ns += __now_ns() - start;
+	} else {
+		current = sched->schedule();
+	}
+	__nr_schedules++;
+
+	/* Going idle and coming back from idle are not switches between processes */
+	if (prev && current && prev != current) nr_context_switches++;
+
+	/* If the system ran a process in the previous tick, */
+	if (prev) {
+		/* Update the process status */
+		if (prev->status == PROCESS_RUNNING) {
+			prev->status = PROCESS_READY;
+		}
+
+		/* Decommission it if completed */
+		if (prev->age == prev->lifespan) {
+			prev->status = PROCESS_EXIT;
+			__exit_process(sched, prev);
+		}
+	}
+}
+
+/**
+ * Run @current of @this_cpu for a tick
+ */
+static __sim_inline void __run_cpu(const struct scheduler *sched)
+{
+	/* No process is ready to run at this moment. Idle temporarily */
+	if (!current) {
+		__print_event(TRACE_IDLE, 0, 0);
+		return;
+	}
+
+	__cpus[this_cpu].busy_ticks++;
+
+	/* Execute the current process */
+	current->status = PROCESS_RUNNING;
+
+	if (current->__first_run_at == UINT_MAX) {
+		current->__first_run_at = ticks;
+	}
+
+	/* Ensure that @current is detached from any list */
+	assert(list_empty(&current->list));
+
+	/* Try acquiring scheduled resources */
+	if (__run_current_acquire(sched)) {
+		/* Succesfully acquired all the resources to make a progress! */
+		__print_event(TRACE_RUN, current->pid, 0);
+
+		/* So, it ages by one tick */
+		current->age++;
+
+		/* And performs scheduled releases */
+		__run_current_release(sched);
+	} else {
+		/**
+		 * The current is blocked while acquiring resource(s).
+		 * In this case, @current could not make a progress in this tick
+		 */
+		__print_event(TRACE_BLOCK, current->pid, 0);
+
+		/* Thus, it is not get aged nor unable to perform releases */
+		current->__blocked_ticks++;
+
+		/* And waits for the resource from the next tick */
+		current->__waiting_since = ticks + 1;
+
+		/**
+		 * Another CPU may wake it up before the next schedule() here. Take
+		 * it off the CPU now not to run it from the ready queue
+		 */
+		if (nr_cpus > 1) {
+			current = NULL;
+		}
+	}
+}
+
+/**
+ * Write a line on how things are going into @samplefile, which is
+ *
+ *   <tick> cpus <pid>/<# ready> ... res <id>:<owner pid>/<# waiters> ... \
+ *          blocked <#> ready <prio>:<#> ...
+ *
+ * with a CPU for each -n, the resources owned or waited for, and a priority
+ * for each original priority of the ready processes, highest first. The pids
+ * of idle CPUs and unowned resources are "-"
+ */
+static void __take_sample(void)
+{
+	unsigned int nr_ready[MAX_PRIO + 1] = { 0 };
+	unsigned int nr_blocked = 0;
+	unsigned int i;
+	struct process *p;
+
+#define __prio_level(p) ((p)->prio_orig < MAX_PRIO ? (p)->prio_orig : MAX_PRIO)
+
+	/**
+	 * The queues are up to the scheduler, so count the live processes, and
+	 * take out the running ones and the waiters below
+	 */
+	for (i = 0; i < proc_slots_nr(); i++) {
+		if (process_slots[i]) nr_ready[__prio_level(process_slots[i])]++;
+	}
+
+	fprintf(samplefile, "%u cpus", ticks);
+	for (unsigned int cpu = 0; cpu < nr_cpus; cpu++) {
+		__switch_cpu(cpu);
+		if (current) {
+			fprintf(samplefile, " %u/%u", current->pid, __nr_ready(sched));
+			nr_ready[__prio_level(current)]--;
+		} else {
+			fprintf(samplefile, " -/%u", __nr_ready(sched));
+		}
+	}
+	__switch_cpu(0);
+
+	fprintf(samplefile, " res");
+	for_each_set_bit(i, __active_resources, nr_resources) {
+		struct resource *r = resources + i;
+		unsigned int nr_waiters = r->waiters.nr;
+
+		list_for_each_entry(p, &r->waitqueue, list) {
+			nr_ready[__prio_level(p)]--;
+			nr_waiters++;
+		}
+		for (int j = 0; j < r->waiters.nr; j++) {
+			p = container_of(r->waiters.nodes[j], struct process, node);
+			nr_ready[__prio_level(p)]--;
+		}
+		nr_blocked += nr_waiters;
+
+		if (r->owner) {
+			fprintf(samplefile, " %d:%u/%u", r->id, r->owner->pid, nr_waiters);
+		} else {
+			fprintf(samplefile, " %d:-/%u", r->id, nr_waiters);
+		}
+	}
+
+	fprintf(samplefile, " blocked %u ready", nr_blocked);
+	for (i = MAX_PRIO + 1; i-- > 0;) {
+		if (nr_ready[i]) fprintf(samplefile, " %u:%u", i, nr_ready[i]);
+	}
+	fprintf(samplefile, "\n");
+
+#undef __prio_level
+
+	/* To be followed while the simulation goes on */
+	fflush(samplefile);
+
+	__next_sample += sample_period;
+}
+
+/**
+ * Tell whether any process is left to run on any CPU
+ */
+static bool __has_pending_process(void)
+{
+	if (!list_empty(&__forkqueue)) return true;
+
+	for (unsigned int cpu = 0; cpu < nr_cpus; cpu++) {
+		__switch_cpu(cpu);
+		if (current || !list_empty(&readyqueue)) {
+			__switch_cpu(0);
+			return true;
+		}
+	}
+	__switch_cpu(0);
+	return false;
+}
+
+
+/***********************************************************************
+ * The main loop for the scheduler simulation
+ */
+static __sim_inline void __simulation_loop(const struct scheduler *sched)
+{
+	assert(sched->schedule && "scheduler.schedule() not implemented");
+
+	while (true) {
+		/* Leave the state at the beginning of the tick to the checkpoint */
+		if (checkpointfile && ticks == checkpoint_tick) break;
+
+		if (streaming && !__stream_forks()) break;
+
+		/* Fork processes on schedule */
+		__fork_on_schedule(sched);
+
+		if (nr_cpus > 1 && ticks % BALANCE_INTERVAL == 0) {
+			__balance_load(sched);
+		}
+
+		for (unsigned int cpu = 0; cpu < nr_cpus; cpu++) {
+			__switch_cpu(cpu);
+			__schedule_cpu(sched);
+		}
+		__switch_cpu(0);
+
+		if (sample_period && ticks == __next_sample) __take_sample();
+
+		/* Quit simulation if no pending process exists */
+		if (!__has_pending_process()) break;
+
+		for (unsigned int cpu = 0; cpu < nr_cpus; cpu++) {
+			__switch_cpu(cpu);
+			__run_cpu(sched);
+		}
+		__switch_cpu(0);
+
+		/* Increase the tick counter */
+		ticks++;
+
+		if (event_driven && nr_cpus == 1) {
+			__skip_to_next_event(sched);
+		}
+	}
+}
+
+#ifdef SCHED_SPECIALIZED
+/**
+ * Simulation loop for @s##_scheduler. The functions on every tick are inlined
+ * into it, so @sched is the very scheduler in there and the calls through its
+ * hooks turn into direct calls, which the compiler may inline as well. The
+ * hooks calling enqueue_process() and dequeue_process() still go through
+ * @sched in them
+ */
+#define SPECIALIZE_SIMULATION(s) \
+	static void __simulate_##s(void) \
+	{ \
+		__simulation_loop(&s##_scheduler); \
+	}
+
+SPECIALIZE_SIMULATION(fifo)
+SPECIALIZE_SIMULATION(sjf)
+SPECIALIZE_SIMULATION(srtf)
+SPECIALIZE_SIMULATION(rr)
+SPECIALIZE_SIMULATION(mlfq)
+SPECIALIZE_SIMULATION(prio)
+SPECIALIZE_SIMULATION(pa)
+SPECIALIZE_SIMULATION(pa_scan)
+SPECIALIZE_SIMULATION(pcp)
+SPECIALIZE_SIMULATION(pip)
+SPECIALIZE_SIMULATION(edf)
+SPECIALIZE_SIMULATION(rm)
+
+static struct {
+	const struct scheduler *sched;
+	void (*simulate)(void);
+} __specialized[] = {
+	{ &fifo_scheduler, __simulate_fifo },
+	{ &sjf_scheduler, __simulate_sjf },
+	{ &srtf_scheduler, __simulate_srtf },
+	{ &rr_scheduler, __simulate_rr },
+	{ &mlfq_scheduler, __simulate_mlfq },
+	{ &prio_scheduler, __simulate_prio },
+	{ &pa_scheduler, __simulate_pa },
+	{ &pa_scan_scheduler, __simulate_pa_scan },
+	{ &pcp_scheduler, __simulate_pcp },
+	{ &pip_scheduler, __simulate_pip },
+	{ &edf_scheduler, __simulate_edf },
+	{ &rm_scheduler, __simulate_rm },
+};
+#endif
+
+/**
+ * Run the simulation with @sched. The specialized build picks the loop made
+ * for @sched, and the others go through the hooks of @sched on every call
+ */
+static void __do_simulation(void)
+{
+#ifdef SCHED_SPECIALIZED
+	for (int i = 0; i < sizeof(__specialized) / sizeof(__specialized[0]); i++) {
+		if (__specialized[i].sched == sched) {
+			__specialized[i].simulate();
+			return;
+		}
+	}
+#endif
+	__simulation_loop(sched);
+}
+
+static void __report_utilization(void)
+{
+	if (quiet || nr_cpus == 1) return;
+
+	output_flush();
+
+	printf("\n");
+	for (unsigned int cpu = 0; cpu < nr_cpus; cpu++) {
+		printf("CPU %2u: busy for %u of %u ticks (%5.1f%%)\n",
+				cpu, __cpus[cpu].busy_ticks, ticks,
+				ticks ? __cpus[cpu].busy_ticks * 100.0 / ticks : 0.0);
+	}
+}
+
+
+/**
+ * Set up the state of a simulation in this thread
+ */
+static void __initialize_simulation(void)
+{
+	INIT_LIST_HEAD(&readyqueue);
+	current = NULL;
+	ticks = 0;
+	this_cpu = 0;
+
+	for (unsigned int cpu = 0; cpu < MAX_CPUS; cpu++) {
+		__cpus[cpu].current = NULL;
+		INIT_LIST_HEAD(&__cpus[cpu].readyqueue);
+		__cpus[cpu].busy_ticks = 0;
+	}
+
+	resources = NULL;
+	nr_resources = 0;
+	__active_resources = NULL;
 
 	INIT_LIST_HEAD(&__forkqueue);
 
-	if (quiet) return;
-	printf("               _              _ \n");
-	printf("              | |            | |\n");
-	printf("      ___  ___| |__   ___  __| |\n");
-	printf("     / __|/ __| '_ \\ / _ \\/ _` |\n");
-	printf("     \\__ \\ (__| | | |  __/ (_| |\n");
-	printf("     |___/\\___|_| |_|\\___|\\__,_|\n");
-	printf("\n");
-	printf("                                 2021 Spring\n");
-	printf("      Simulating %s scheduler\n", sched->name);
-	printf("\n");
-	printf("****************************************************\n");
-	printf("   N: Forked\n");
-	printf("   X: Finished\n");
-	printf("   =: Blocked\n");
-	printf("  +n: Acquire resource n\n");
-	printf("  -n: Release resource n\n");
-	printf("\n");
+	pool_init(&__process_pool, sizeof(struct process), 64);
+	pool_init(&__resource_schedule_pool, sizeof(struct resource_schedule), 64);
+	proc_slots_init();
+
+	metrics_init();
+}
+
+/**
+ * Release what the simulation in this thread has allocated
+ */
+static void __finalize_simulation(void)
+{
+	for (unsigned int i = 0; i < nr_resources; i++) {
+		heap_destroy(&(resources[i].waiters));
+	}
+	free(resources);
+	free(__active_resources);
+
+	pool_destroy(&__resource_schedule_pool);
+	pool_destroy(&__process_pool);
+	proc_slots_destroy();
+
+	metrics_destroy();
+}
+
+static void __initialize(void)
+{
+	__initialize_simulation();
+
+	output_init();
+
+	if (quiet) return;
+	printf("               _              _ \n");
+	printf("              | |            | |\n");
+	printf("      ___  ___| |__   ___  __| |\n");
+	printf("     / __|/ __| '_ \\ / _ \\/ _` |\n");
+	printf("     \\__ \\ (__| | | |  __/ (_| |\n");
+	printf("     |___/\\___|_| |_|\\___|\\__,_|\n");
+	printf("\n");
+	printf("                                 2021 Spring\n");
+	printf("      Simulating %s scheduler\n", sched->name);
+	printf("\n");
+	printf("****************************************************\n");
+	printf("   N: Forked\n");
+	printf("   X: Finished\n");
+	printf("   =: Blocked\n");
+	if (sched->admit) printf("   R: Rejected\n");
+	printf("  +n: Acquire resource n\n");
+	printf("  -n: Release resource n\n");
+	printf("\n");
+}
+
+
+/***********************************************************************
+ * Checkpoint
+ *
+ * Save the state of the simulation at the beginning of a tick (-K), and
+ * continue the simulation from there later (-R), optionally with another
+ * set of processes to fork from the tick on. See checkpoint.h
+ */
+
+/**
+ * The flag to select @s
+ */
+static char __scheduler_flag(const struct scheduler *s)
+{
+	for (int i = 0; i < sizeof(__schedulers) / sizeof(__schedulers[0]); i++) {
+		if (__schedulers[i].sched == s) return __schedulers[i].flag;
+	}
+	return 0;
+}
+
+/**
+ * Tell whether the framework can take the ready queues of @s apart
+ */
+static bool __can_checkpoint(const struct scheduler *s)
+{
+	return !s->enqueue || s->drain || s->steal;
+}
+
+/**
+ * Take a process out of the ready queue of @this_cpu in the order to put
+ * them back. NULL if the ready queue is empty
+ */
+static struct process *__drain_process(void)
+{
+	struct process *p;
+
+	if (sched->drain) return sched->drain();
+	if (sched->enqueue) return sched->steal();
+
+	if (list_empty(&readyqueue)) return NULL;
+
+	p = list_first_entry(&readyqueue, struct process, list);
+	list_del_init(&p->list);
+	return p;
+}
+
+static struct checkpoint_acquire __save_acquire(struct resource_schedule *rs, uint32_t flags)
+{
+	return (struct checkpoint_acquire) {
+		.resource = rs->resource_id,
+		.at = rs->at,
+		.duration = rs->duration,
+		.flags = flags | (rs->contended ? CHECKPOINT_CONTENDED : 0),
+		.blocked_at = rs->blocked_at,
+		.acquired_at = rs->acquired_at,
+	};
+}
+
+/**
+ * Write the state of the simulation into @filename in the checkpoint
+ * format. The ready queues and the heaps are taken apart to read them in
+ * order, so the simulation cannot go on afterwards
+ */
+static bool __save_checkpoint(char * const filename)
+{
+	struct checkpoint_header header = {
+		.sched = __scheduler_flag(sched),
+		.rr_quantum = rr_quantum,
+		.pa_aging_period = pa_aging_period,
+		.ticks = ticks,
+		.cpu_width = cpu_width,
+		.nr_cpus = nr_cpus,
+	};
+	struct checkpoint_cpu cpus[MAX_CPUS];
+	struct checkpoint_process *cp;
+	struct checkpoint_acquire *ca;
+	struct checkpoint_resource *cr;
+	struct checkpoint_waiter *cw;
+	uint32_t *owned, *ready;
+	unsigned int nr_slots = proc_slots_nr();
+	unsigned int *index;		/* Of the process in each slot */
+	struct process **processes;
+	struct process *p;
+	struct resource_schedule *rs;
+	struct resource *r;
+	struct heap_node *node;
+	unsigned int nr_owned = 0, nr_waiters = 0, nr_ready = 0;
+	void *metrics;
+	size_t metrics_size;
+	bool written = false;
+	FILE *file;
+
+	memcpy(header.magic, CHECKPOINT_MAGIC, CHECKPOINT_MAGIC_LEN);
+
+	/* Live processes are in the slots, and the rest are to fork */
+	index = malloc(sizeof(*index) * nr_slots + 1);
+	assert(index);
+	for (unsigned int i = 0; i < nr_slots; i++) {
+		if (process_slots[i]) index[i] = header.nr_live++;
+	}
+	header.nr_processes = header.nr_live;
+	list_for_each_entry(p, &__forkqueue, list) {
+		header.nr_processes++;
+	}
+
+	processes = malloc(sizeof(*processes) * header.nr_processes + 1);
+	assert(processes);
+	for (unsigned int i = 0; i < nr_slots; i++) {
+		if (process_slots[i]) processes[index[i]] = process_slots[i];
+	}
+	header.nr_processes = header.nr_live;
+	list_for_each_entry(p, &__forkqueue, list) {
+		processes[header.nr_processes++] = p;
+	}
+
+	for (unsigned int i = 0; i < header.nr_processes; i++) {
+		p = processes[i];
+		list_for_each_entry(rs, &p->__resources_to_acquire, list) {
+			header.nr_acquires++;
+		}
+		header.nr_acquires += p->__resources_holding.nr;
+		list_for_each_entry(r, &p->resources_owned, owned) {
+			header.nr_owned++;
+		}
+	}
+
+	header.nr_resources = nr_resources;
+	for (unsigned int i = 0; i < nr_resources; i++) {
+		list_for_each_entry(p, &resources[i].waitqueue, list) {
+			header.nr_waiters++;
+		}
+		header.nr_waiters += resources[i].waiters.nr;
+	}
+
+	cp = malloc(sizeof(*cp) * header.nr_processes + 1);
+	ca = malloc(sizeof(*ca) * header.nr_acquires + 1);
+	owned = malloc(sizeof(*owned) * header.nr_owned + 1);
+	cr = malloc(sizeof(*cr) * header.nr_resources + 1);
+	cw = malloc(sizeof(*cw) * header.nr_waiters + 1);
+	ready = malloc(sizeof(*ready) * header.nr_live + 1);
+	assert(cp && ca && owned && cr && cw && ready);
+
+	/**
+	 * Drain the ready queues first. Schedulers may settle the priorities of
+	 * the processes while taking them out
+	 */
+	for (unsigned int cpu = 0; cpu < nr_cpus; cpu++) {
+		__switch_cpu(cpu);
+
+		cpus[cpu] = (struct checkpoint_cpu) {
+			.current = current ? index[current->slot] : CHECKPOINT_NONE,
+			.busy_ticks = __cpus[cpu].busy_ticks,
+			.state = sched->save ? sched->save() : 0,
+		};
+		while ((p = __drain_process())) {
+			assert(nr_ready < header.nr_live);
+			ready[nr_ready++] = index[p->slot];
+			cpus[cpu].nr_ready++;
+		}
+	}
+	__switch_cpu(0);
+	header.nr_ready = nr_ready;
+
+	header.nr_acquires = 0;
+	for (unsigned int i = 0; i < header.nr_processes; i++) {
+		p = processes[i];
+
+		cp[i] = (struct checkpoint_process) {
+			.pid = p->pid,
+			.status = p->status,
+			.age = p->age,
+			.lifespan = p->lifespan,
+			.prio = p->prio,
+			.prio_orig = p->prio_orig,
+			.cpu = p->cpu,
+			.slice_start = p->slice_start,
+			.level = p->level,
+			.boosted_at = p->boosted_at,
+			.period = p->period,
+			.deadline = p->deadline,
+			.deadline_at = p->deadline_at,
+			.dl_key = p->dl_key,
+			.blocked_on = p->blocked_on ? p->blocked_on - resources : CHECKPOINT_NONE,
+			.starts_at = p->__starts_at,
+			.forked_at = p->__forked_at,
+			.first_run_at = p->__first_run_at,
+			.blocked_ticks = p->__blocked_ticks,
+			.waiting_since = p->__waiting_since,
+			.waiting_ticks = p->__waiting_ticks,
+		};
+
+		list_for_each_entry(rs, &p->__resources_to_acquire, list) {
+			ca[header.nr_acquires++] = __save_acquire(rs, 0);
+			cp[i].nr_acquires++;
+		}
+		while ((node = heap_pop(&p->__resources_holding))) {
+			rs = container_of(node, struct resource_schedule, node);
+			ca[header.nr_acquires++] = __save_acquire(rs, CHECKPOINT_HOLDING);
+			cp[i].nr_acquires++;
+		}
+		heap_destroy(&p->__resources_holding);
+
+		list_for_each_entry(r, &p->resources_owned, owned) {
+			owned[nr_owned++] = r - resources;
+			cp[i].nr_owned++;
+		}
+	}
+
+	for (unsigned int i = 0; i < nr_resources; i++) {
+		r = resources + i;
+
+		cr[i] = (struct checkpoint_resource) {
+			.id = r->id,
+			.ceiling = r->ceiling,
+			.owner = r->owner ? index[r->owner->slot] : CHECKPOINT_NONE,
+		};
+
+		list_for_each_entry(p, &r->waitqueue, list) {
+			cw[nr_waiters++] = (struct checkpoint_waiter) {
+				.process = index[p->slot],
+			};
+			cr[i].nr_waiters++;
+		}
+		while ((node = heap_peek(&r->waiters))) {
+			cw[nr_waiters++] = (struct checkpoint_waiter) {
+				.process = index[container_of(node, struct process, node)->slot],
+				.flags = CHECKPOINT_WAITER_HEAP,
+				.key = node->key,
+			};
+			cr[i].nr_waiters++;
+			heap_pop(&r->waiters);
+		}
+	}
+
+	metrics = metrics_save(&metrics_size);
+
+	file = fopen(filename, "wb");
+	if (!file) {
+		fprintf(stderr, "Unable to open %s\n", filename);
+		goto out;
+	}
+
+	fwrite(&header, sizeof(header), 1, file);
+	fwrite(cp, sizeof(*cp), header.nr_processes, file);
+	fwrite(ca, sizeof(*ca), header.nr_acquires, file);
+	fwrite(owned, sizeof(*owned), header.nr_owned, file);
+	fwrite(cr, sizeof(*cr), header.nr_resources, file);
+	fwrite(cw, sizeof(*cw), header.nr_waiters, file);
+	fwrite(cpus, sizeof(*cpus), header.nr_cpus, file);
+	fwrite(ready, sizeof(*ready), header.nr_ready, file);
+	fwrite(metrics, metrics_size, 1, file);
+
+	if (fclose(file)) {
+		fprintf(stderr, "Unable to write %s\n", filename);
+		goto out;
+	}
+	written = true;
+
+out:
+	free(metrics);
+	free(ready);
+	free(cw);
+	free(cr);
+	free(owned);
+	free(ca);
+	free(cp);
+	free(processes);
+	free(index);
+	return written;
+}
+
+/**
+ * Sections of a checkpoint image read in memory
+ */
+struct __checkpoint {
+	char *image;
+	const struct checkpoint_header *header;
+	const struct checkpoint_process *processes;
+	const struct checkpoint_acquire *acquires;
+	const uint32_t *owned;
+	const struct checkpoint_resource *resources;
+	const struct checkpoint_waiter *waiters;
+	const struct checkpoint_cpu *cpus;
+	const uint32_t *ready;
+	const char *metrics;
+	size_t metrics_size;
+};
+
+/**
+ * Tell whether the sections of @c refer to the processes and the resources
+ * in it consistently
+ */
+static bool __validate_checkpoint(const struct __checkpoint *c)
+{
+	const struct checkpoint_header *h = c->header;
+	unsigned int nr_acquires = 0, nr_owned = 0, nr_waiters = 0, nr_ready = 0;
+
+	if (!__find_scheduler(h->sched) || !h->nr_cpus || h->nr_cpus > MAX_CPUS ||
+			h->nr_live > h->nr_processes) {
+		return false;
+	}
+
+	for (unsigned int i = 0; i < h->nr_processes; i++) {
+		const struct checkpoint_process *cp = c->processes + i;
+
+		if ((cp->blocked_on != CHECKPOINT_NONE && cp->blocked_on >= h->nr_resources) ||
+				cp->nr_acquires > h->nr_acquires - nr_acquires ||
+				cp->nr_owned > h->nr_owned - nr_owned ||
+				(i >= h->nr_live && cp->nr_owned)) {
+			return false;
+		}
+		for (unsigned int j = 0; j < cp->nr_acquires; j++) {
+			const struct checkpoint_acquire *ca = c->acquires + nr_acquires + j;
+
+			if (ca->resource >= h->nr_resources ||
+					(i >= h->nr_live && (ca->flags & CHECKPOINT_HOLDING))) {
+				return false;
+			}
+		}
+		nr_acquires += cp->nr_acquires;
+		nr_owned += cp->nr_owned;
+	}
+
+	for (unsigned int i = 0; i < h->nr_owned; i++) {
+		if (c->owned[i] >= h->nr_resources) return false;
+	}
+
+	for (unsigned int i = 0; i < h->nr_resources; i++) {
+		const struct checkpoint_resource *cr = c->resources + i;
+
+		if ((cr->owner != CHECKPOINT_NONE && cr->owner >= h->nr_live) ||
+				cr->nr_waiters > h->nr_waiters - nr_waiters) {
+			return false;
+		}
+		nr_waiters += cr->nr_waiters;
+	}
+
+	for (unsigned int i = 0; i < h->nr_waiters; i++) {
+		if (c->waiters[i].process >= h->nr_live) return false;
+	}
+
+	for (unsigned int cpu = 0; cpu < h->nr_cpus; cpu++) {
+		const struct checkpoint_cpu *cc = c->cpus + cpu;
+
+		if ((cc->current != CHECKPOINT_NONE && cc->current >= h->nr_live) ||
+				cc->nr_ready > h->nr_ready - nr_ready) {
+			return false;
+		}
+		nr_ready += cc->nr_ready;
+	}
+
+	for (unsigned int i = 0; i < h->nr_ready; i++) {
+		if (c->ready[i] >= h->nr_live) return false;
+	}
+
+	return nr_acquires == h->nr_acquires && nr_owned == h->nr_owned &&
+			nr_waiters == h->nr_waiters && nr_ready == h->nr_ready;
+}
+
+/**
+ * Read the checkpoint image in @filename into @c
+ */
+static bool __read_checkpoint(char * const filename, struct __checkpoint *c)
+{
+	const struct checkpoint_header *h;
+	struct stat st;
+	size_t offset;
+	FILE *file;
+
+	file = fopen(filename, "rb");
+	if (!file || fstat(fileno(file), &st)) {
+		fprintf(stderr, "Unable to open %s\n", filename);
+		if (file) fclose(file);
+		return false;
+	}
+
+	c->image = malloc(st.st_size + 1);
+	assert(c->image);
+
+	if (fread(c->image, 1, st.st_size, file) != st.st_size) {
+		fprintf(stderr, "Unable to read %s\n", filename);
+		fclose(file);
+		goto corrupted;
+	}
+	fclose(file);
+
+	h = c->header = (const void *)c->image;
+	if (st.st_size < sizeof(*h) ||
+			memcmp(h->magic, CHECKPOINT_MAGIC, CHECKPOINT_MAGIC_LEN)) {
+		goto corrupted;
+	}
+
+	offset = sizeof(*h);
+	c->processes = (const void *)(c->image + offset);
+	offset += sizeof(*c->processes) * h->nr_processes;
+	c->acquires = (const void *)(c->image + offset);
+	offset += sizeof(*c->acquires) * h->nr_acquires;
+	c->owned = (const void *)(c->image + offset);
+	offset += sizeof(*c->owned) * h->nr_owned;
+	c->resources = (const void *)(c->image + offset);
+	offset += sizeof(*c->resources) * h->nr_resources;
+	c->waiters = (const void *)(c->image + offset);
+	offset += sizeof(*c->waiters) * h->nr_waiters;
+	c->cpus = (const void *)(c->image + offset);
+	offset += sizeof(*c->cpus) * h->nr_cpus;
+	c->ready = (const void *)(c->image + offset);
+	offset += sizeof(*c->ready) * h->nr_ready;
+
+	if (offset > st.st_size || !__validate_checkpoint(c)) goto corrupted;
+
+	c->metrics = c->image + offset;
+	c->metrics_size = st.st_size - offset;
+	return true;
+
+corrupted:
+	fprintf(stderr, "Corrupted checkpoint %s\n", filename);
+	free(c->image);
+	c->image = NULL;
+	return false;
+}
+
+/**
+ * Resolve the resource ids of the processes in @__forkqueue with the @nr
+ * resources of @ids, and append the ids not in @ids to @ids, which has
+ * room for them. Return the # of the resources then
+ */
+static unsigned int __resolve_resource_ids(int *ids, unsigned int nr)
+{
+	unsigned int size = 1, nr_acquires = 0;
+	struct __resource_slot *slots;
+	struct process *p;
+	struct resource_schedule *rs;
+
+	list_for_each_entry(p, &__forkqueue, list) {
+		list_for_each_entry(rs, &p->__resources_to_acquire, list) {
+			nr_acquires++;
+		}
+	}
+
+	/* Keep the table at most half full */
+	while (size < (nr + nr_acquires) * 2) size <<= 1;
+
+	slots = malloc(sizeof(*slots) * size);
+	assert(slots);
+
+	for (unsigned int i = 0; i < size; i++) {
+		slots[i].id = -1;
+	}
+	for (unsigned int i = 0; i < nr; i++) {
+		struct __resource_slot *slot = __resource_slot(slots, size - 1, ids[i]);
+
+		slot->id = ids[i];
+		slot->index = i;
+	}
+
+	list_for_each_entry(p, &__forkqueue, list) {
+		list_for_each_entry(rs, &p->__resources_to_acquire, list) {
+			struct __resource_slot *slot =
+					__resource_slot(slots, size - 1, rs->resource_id);
+
+			if (slot->id < 0) {
+				slot->id = rs->resource_id;
+				slot->index = nr;
+				ids[nr++] = rs->resource_id;
+			}
+			rs->resource_id = slot->index;
+		}
+	}
+
+	free(slots);
+	return nr;
+}
+
+/**
+ * Bring back the processes and the resources in @c. The processes to fork
+ * are replaced with the ones in @tailfile if it is given
+ */
+static bool __restore_checkpoint(const struct __checkpoint *c, char * const tailfile)
+{
+	const struct checkpoint_header *h = c->header;
+	const struct checkpoint_acquire *ca = c->acquires;
+	const uint32_t *owned = c->owned;
+	const struct checkpoint_waiter *cw = c->waiters;
+	unsigned int nr_processes = tailfile ? h->nr_live : h->nr_processes;
+	struct process *p;
+	struct resource_schedule *rs;
+	int *ids;
+
+	ticks = h->ticks;
+	cpu_width = h->cpu_width;
+
+	for (unsigned int i = 0; i < nr_processes; i++) {
+		const struct checkpoint_process *cp = c->processes + i;
+
+		p = __alloc_process(cp->pid);
+		p->status = cp->status;
+		p->age = cp->age;
+		p->lifespan = cp->lifespan;
+		p->prio = cp->prio;
+		p->prio_orig = cp->prio_orig;
+		p->cpu = cp->cpu;
+		p->slice_start = cp->slice_start;
+		p->level = cp->level;
+		p->boosted_at = cp->boosted_at;
+		p->period = cp->period;
+		p->deadline = cp->deadline;
+		p->deadline_at = cp->deadline_at;
+		p->dl_key = cp->dl_key;
+		p->__starts_at = cp->starts_at;
+		p->__forked_at = cp->forked_at;
+		p->__first_run_at = cp->first_run_at;
+		p->__blocked_ticks = cp->blocked_ticks;
+		p->__waiting_since = cp->waiting_since;
+		p->__waiting_ticks = cp->waiting_ticks;
+
+		for (unsigned int j = 0; j < cp->nr_acquires; j++, ca++) {
+			rs = __add_resource_schedule(p, ca->resource, ca->at, ca->duration);
+			rs->contended = (ca->flags & CHECKPOINT_CONTENDED) != 0;
+			rs->blocked_at = ca->blocked_at;
+			rs->acquired_at = ca->acquired_at;
+
+			/* The ones held go to the heap in the order to release them */
+			if (ca->flags & CHECKPOINT_HOLDING) {
+				list_del_init(&rs->list);
+				heap_push(&p->__resources_holding, &rs->node, rs->at + rs->duration);
+			}
+		}
+
+		/* Live processes get the slots in the order they were saved */
+		if (i < h->nr_live) {
+			proc_slot_alloc(p);
+		} else {
+			__queue_fork(p);
+		}
+	}
+
+	ids = malloc(sizeof(*ids) * h->nr_resources + 1);
+	assert(ids);
+	for (unsigned int i = 0; i < h->nr_resources; i++) {
+		ids[i] = c->resources[i].id;
+	}
+	nr_resources = h->nr_resources;
+
+	/* The resources only the tail refers to come after the saved ones */
+	if (tailfile) {
+		unsigned int nr_acquires = 0;
+
+		if (!__read_script(tailfile)) goto failed;
+
+		list_for_each_entry(p, &__forkqueue, list) {
+			if (p->__starts_at < ticks) {
+				fprintf(stderr, "Process %d starts before the checkpoint at tick %u\n",
+						p->pid, ticks);
+				goto failed;
+			}
+			list_for_each_entry(rs, &p->__resources_to_acquire, list) {
+				if (rs->resource_id < 0) {
+					fprintf(stderr, "Invalid resource %d for process %d\n",
+							rs->resource_id, p->pid);
+					goto failed;
+				}
+				nr_acquires++;
+			}
+		}
+
+		ids = realloc(ids, sizeof(*ids) * (h->nr_resources + nr_acquires) + 1);
+		assert(ids);
+		nr_resources = __resolve_resource_ids(ids, h->nr_resources);
+
+		if (!quiet) printf("\n");
+	}
+	__alloc_resources(nr_resources, ids);
+	free(ids);
+
+	for (unsigned int i = 0; i < h->nr_resources; i++) {
+		const struct checkpoint_resource *cr = c->resources + i;
+		struct resource *r = resources + i;
+
+		r->ceiling = cr->ceiling;
+		if (cr->owner != CHECKPOINT_NONE) {
+			r->owner = process_slots[cr->owner];
+		}
+
+		for (unsigned int j = 0; j < cr->nr_waiters; j++, cw++) {
+			p = process_slots[cw->process];
+
+			if (cw->flags & CHECKPOINT_WAITER_HEAP) {
+				heap_push(&r->waiters, &p->node, cw->key);
+			} else {
+				list_add_tail(&p->list, &r->waitqueue);
+			}
+		}
+		__update_active_resource(i);
+	}
+	__set_ceilings();
+
+	for (unsigned int i = 0; i < h->nr_live; i++) {
+		const struct checkpoint_process *cp = c->processes + i;
+
+		p = process_slots[i];
+		if (cp->blocked_on != CHECKPOINT_NONE) {
+			p->blocked_on = resources + cp->blocked_on;
+		}
+		for (unsigned int j = 0; j < cp->nr_owned; j++) {
+			list_add_tail(&resources[*owned++].owned, &p->resources_owned);
+		}
+	}
+
+	if (!metrics_restore(c->metrics, c->metrics_size)) {
+		fprintf(stderr, "Corrupted checkpoint metrics\n");
+		return false;
+	}
+	return true;
+
+failed:
+	free(ids);
+	return false;
+}
+
+/**
+ * Put back the processes on the CPUs and in the ready queues in @c. The
+ * scheduler should be initialized
+ */
+static void __restore_cpus(const struct __checkpoint *c)
+{
+	const uint32_t *ready = c->ready;
+
+	for (unsigned int cpu = 0; cpu < nr_cpus; cpu++) {
+		const struct checkpoint_cpu *cc = c->cpus + cpu;
+
+		__switch_cpu(cpu);
+
+		if (cc->current != CHECKPOINT_NONE) {
+			current = process_slots[cc->current];
+		}
+		__cpus[cpu].busy_ticks = cc->busy_ticks;
+
+		if (sched->restore) sched->restore(cc->state);
+
+		for (unsigned int i = 0; i < cc->nr_ready; i++) {
+			struct process *p = process_slots[*ready++];
+
+			if (sched->refill) {
+				sched->refill(p);
+			} else {
+				enqueue_process(p);
+			}
+		}
+	}
+	__switch_cpu(0);
+}
+
+
+/***********************************************************************
+ * Sweep mode
+ *
+ * Simulate the workload with each of the schedulers selected with -x, and
+ * with each of the parameters given for the scheduler, in parallel. The
+ * workload is loaded once and handed to the simulations in the binary
+ * workload format, from which each simulation builds its own processes.
+ */
+#define MAX_SWEEP_PARAMS	16
+#define MAX_SWEEP_THREADS	1024	/* Maximum # of threads to sweep with (-j) */
+
+struct sweep_run {
+	const struct scheduler *sched;
+	unsigned int quantum;		/* 0 if not applicable */
+	unsigned int aging_period;	/* 0 if not applicable */
+
+	bool done;
+	unsigned int ticks;
+	unsigned int busy_ticks;
+	unsigned int nr_exited;
+	double turnaround;
+	double response;
+	double ready;
+	double waiting;
+	unsigned long nr_context_switches;
+};
+
+struct sweep {
+	const char *workload;
+	size_t size;
+	struct sweep_run *runs;
+	unsigned int nr_runs;
+	unsigned int next;			/* Index of the run to take next */
+};
+
+static void __simulate(struct sweep_run *run, const char *workload, size_t size)
+{
+	sched = run->sched;
+	if (run->quantum) rr_quantum = run->quantum;
+	if (run->aging_period) pa_aging_period = run->aging_period;
+
+	__initialize_simulation();
+
+	/* Cannot fail as __build_workload() made it */
+	__load_workload(workload, size);
+	__build_resources();
+
+	if (!sched->initialize || !sched->initialize()) {
+		__do_simulation();
+
+		if (sched->finalize) sched->finalize();
+
+		run->done = true;
+		run->ticks = ticks;
+		for (unsigned int cpu = 0; cpu < nr_cpus; cpu++) {
+			run->busy_ticks += __cpus[cpu].busy_ticks;
+		}
+		run->nr_exited = metrics_nr_samples();
+		run->turnaround = metrics_average(METRIC_TURNAROUND);
+		run->response = metrics_average(METRIC_RESPONSE);
+		run->ready = metrics_average(METRIC_READY);
+		run->waiting = metrics_average(METRIC_WAITING);
+		run->nr_context_switches = nr_context_switches;
+	}
+
+	__finalize_simulation();
+}
+
+static void *__sweep_worker(void *arg)
+{
+	struct sweep *sweep = arg;
+	unsigned int i;
+
+	while ((i = __sync_fetch_and_add(&sweep->next, 1)) < sweep->nr_runs) {
+		__simulate(sweep->runs + i, sweep->workload, sweep->size);
+	}
+	return NULL;
+}
+
+static void __print_sweep(const struct sweep *sweep)
+{
+	printf("%-30s %-8s %8s %6s %8s %11s %9s %9s %9s %9s\n", "Scheduler",
+			"Param", "Ticks", "Util", "Exited", "Turnaround", "Response",
+			"Ready", "Waiting", "Switches");
+
+	for (unsigned int i = 0; i < sweep->nr_runs; i++) {
+		const struct sweep_run *run = sweep->runs + i;
+		char param[32] = "-";
+
+		if (run->quantum) {
+			snprintf(param, sizeof(param), "q=%u", run->quantum);
+		} else if (run->aging_period) {
+			snprintf(param, sizeof(param), "aging=%u", run->aging_period);
+		}
+
+		if (!run->done) {
+			printf("%-30s %-8s %8s\n", run->sched->name, param, "failed");
+			continue;
+		}
+
+		printf("%-30s %-8s %8u %5.1f%% %8u %11.2f %9.2f %9.2f %9.2f %9lu\n",
+				run->sched->name, param, run->ticks,
+				run->ticks ? run->busy_ticks * 100.0 / run->ticks / nr_cpus : 0.0,
+				run->nr_exited, run->turnaround, run->response, run->ready,
+				run->waiting, run->nr_context_switches);
+	}
+}
+
+/**
+ * Run the sweep over the schedulers with the flags in @flags with
+ * @nr_threads threads. The time-slicing schedulers run with each of @quanta,
+ * and the aging schedulers do with each of @aging_periods
+ */
+static bool __sweep(const char *flags,
+		const unsigned int *quanta, unsigned int nr_quanta,
+		const unsigned int *aging_periods, unsigned int nr_aging_periods,
+		unsigned int nr_threads)
+{
+	struct sweep sweep = {
+		.next = 0,
+	};
+	unsigned int nr_started = 0;
+	char *workload;
+
+	if (!*flags) {
+		fprintf(stderr, "No scheduler to sweep\n");
+		return false;
+	}
+
+	sweep.runs = calloc(strlen(flags) * MAX_SWEEP_PARAMS, sizeof(*sweep.runs));
+	assert(sweep.runs);
+
+	for (const char *flag = flags; *flag; flag++) {
+		const struct scheduler *s = __find_scheduler(*flag);
+
+		if (!s) {
+			fprintf(stderr, "Unknown scheduler -%c to sweep\n", *flag);
+			free(sweep.runs);
+			return false;
+		}
+
+		if ((s == &rr_scheduler || s == &mlfq_scheduler) && nr_quanta) {
+			for (unsigned int i = 0; i < nr_quanta; i++) {
+				sweep.runs[sweep.nr_runs].sched = s;
+				sweep.runs[sweep.nr_runs++].quantum = quanta[i];
+			}
+		} else if ((s == &pa_scheduler || s == &pa_scan_scheduler) &&
+				nr_aging_periods) {
+			for (unsigned int i = 0; i < nr_aging_periods; i++) {
+				sweep.runs[sweep.nr_runs].sched = s;
+				sweep.runs[sweep.nr_runs++].aging_period = aging_periods[i];
+			}
+		} else {
+			sweep.runs[sweep.nr_runs++].sched = s;
+		}
+	}
+
+	/* Hand the processes over to the simulations, and leave the stage */
+	workload = __build_workload(&sweep.size);
+	sweep.workload = workload;
+	__finalize_simulation();
+
+	mute = true;
+
+	if (nr_threads > sweep.nr_runs) nr_threads = sweep.nr_runs;
+	pthread_t threads[nr_threads];
+
+	/* This thread works as one of them */
+	for (unsigned int i = 1; i < nr_threads; i++) {
+		if (pthread_create(threads + i, NULL, __sweep_worker, &sweep)) break;
+		nr_started++;
+	}
+	__sweep_worker(&sweep);
+
+	for (unsigned int i = 1; i <= nr_started; i++) {
+		pthread_join(threads[i], NULL);
+	}
+
+	__print_sweep(&sweep);
+
+	free(workload);
+	free(sweep.runs);
+	return true;
+}
+
+/**
+ * Parse the comma-separated list of numbers in @str into @values
+ */
+static unsigned int __parse_params(const char *str, unsigned int *values)
+{
+	unsigned int nr_values = 0;
+	char *end;
+
+	do {
+		long value = strtol(str, &end, 10);
+
+		if (end == str || value <= 0 || nr_values == MAX_SWEEP_PARAMS) return 0;
+		values[nr_values++] = value;
+		str = end + 1;
+	} while (*end == ',');
+
+	return *end ? 0 : nr_values;
 }
 
 
 static void __print_usage(char * const name)
 {
-	printf("Usage: %s {-q} -[f|s|S|r|a|p|i] [process script file]\n", name);
+	printf("Usage: %s {-q|-qq} {-e} {-M} {-B} {-n cpus} {-w workload} {-T trace} {-x flags {-j threads}} {-Q quanta} {-A periods} {-K tick:image} {-R image} {-F} {-I ticks:file} -[f|s|S|r|m|a|p|i|d|t] [process script file]\n", name);
 	printf("\n");
-	printf("  -q: Run quietly\n\n");
+	printf("  -q: Run quietly. Give it twice (-qq) not to put out the events but into -T\n");
+	printf("  -e: Jump over the ticks without events (single CPU only)\n");
+	printf("  -M: Print the scheduling metrics and resource contention at the end\n");
+	printf("  -B: Time the simulation without putting out the events\n");
+	printf("  -n [cpus]: Simulate up to %d CPUs with per-CPU ready queues\n", MAX_CPUS);
+	printf("  -w [workload file]: Convert the script into a binary workload and exit\n");
+	printf("  -T [trace file]: Write the events into the trace file as well\n");
+	printf("  -x [flags]: Compare the schedulers with the flags (e.g., fsSr) in parallel\n");
+	printf("  -j [threads]: Run up to this many (up to %d) simulations at once for -x\n",
+			MAX_SWEEP_THREADS);
+	printf("  -Q [quanta]: Time quantum for -r and -m. Comma-separated to sweep\n");
+	printf("  -A [periods]: Age every this many rounds with -a and -P. Comma-separated to sweep\n");
+	printf("  -K [tick:image]: Stop at the beginning of the tick and save the state into the image\n");
+	printf("  -R [image]: Continue from the checkpoint image. The processes in the script, if\n");
+	printf("              given, are forked from there instead of the ones left in the image\n");
+	printf("  -F: Stream the processes from the script sorted by the start instead of loading\n");
+	printf("      all of them in advance\n");
+	printf("  -I [ticks:file]: Every this many ticks, write the processes on and ready for each\n");
+	printf("                   CPU, the ready ones by priority, and the owner and waiters of\n");
+	printf("                   the resources in use into the file\n\n");
 	printf("  -f: Use FIFO scheduler (default)\n");
 	printf("  -s: Use SJF scheduler\n");
 	printf("  -S: Use SRTF scheduler\n");
 	printf("  -r: Use Round-robin scheduler\n");
+	printf("  -m: Use Multi-level feedback queue scheduler\n");
 	printf("  -p: Use Priority scheduler\n");
 	printf("  -a: Use Priority scheduler with aging\n");
+	printf("  -P: Use Priority scheduler with aging over the compact process table\n");
 	printf("  -c: Use Priority scheduler with PCP\n");
 	printf("  -i: Use Priority scheduler with PIP\n");
+	printf("  -d: Use EDF scheduler admitting processes up to the full utilization\n");
+	printf("  -t: Use Rate-monotonic scheduler admitting processes up to the Liu-Layland bound\n");
 	printf("\n");
 }
 
@@ -442,68 +3058,303 @@ static void __print_usage(char * const name)
 int main(int argc, char * const argv[])
 {
 	int opt;
-	char *scriptfile;
-
-	while ((opt = getopt(argc, argv, "qfsSrpaich")) != -1) {
+	char *scriptfile = NULL;
+	char *workloadfile = NULL;
+	char *restorefile = NULL;
+	char *samplefilename = NULL;
+	struct __checkpoint checkpoint = {
+		.image = NULL,
+	};
+	bool sched_selected = false;
+	bool cpus_given = false;
+	char *end;
+	char *tracefile = NULL;
+	char *sweepflags = NULL;
+	unsigned int nr_threads = sysconf(_SC_NPROCESSORS_ONLN);
+	unsigned int quanta[MAX_SWEEP_PARAMS];
+	unsigned int nr_quanta = 0;
+	unsigned int aging_periods[MAX_SWEEP_PARAMS];
+	unsigned int nr_aging_periods = 0;
+	unsigned long long bench_start = 0;
+
+	while ((opt = getopt(argc, argv, "qeMBFn:w:T:x:j:Q:A:K:R:I:fsSrmpaPicdth")) != -1) {
 		switch (opt) {
 		case 'q':
+			/* -qq to run headless */
+			if (quiet) headless = true;
 			quiet = true;
 			break;
-
-		case 'f':
-			sched = &fifo_scheduler;
+		case 'e':
+			event_driven = true;
 			break;
-		case 's':
-			sched = &sjf_scheduler;
+		case 'M':
+			print_metrics = true;
 			break;
-		case 'S':
-			sched = &srtf_scheduler;
+		case 'B':
+			bench = true;
+			break;
+		case 'F':
+			streaming = true;
+			break;
+		case 'n':
+			nr_cpus = atoi(optarg);
+			if (nr_cpus < 1 || nr_cpus > MAX_CPUS) {
+				__print_usage(argv[0]);
+				return EXIT_FAILURE;
+			}
+			cpus_given = true;
+			break;
+		case 'w':
+			workloadfile = optarg;
+			break;
+		case 'T':
+			tracefile = optarg;
+			break;
+		case 'x':
+			sweepflags = optarg;
+			break;
+		case 'j':
+			nr_threads = atoi(optarg);
+			if (nr_threads < 1 || nr_threads > MAX_SWEEP_THREADS) {
+				__print_usage(argv[0]);
+				return EXIT_FAILURE;
+			}
 			break;
-		case 'r':
-			sched = &rr_scheduler;
+		case 'Q':
+			nr_quanta = __parse_params(optarg, quanta);
+			if (!nr_quanta) {
+				__print_usage(argv[0]);
+				return EXIT_FAILURE;
+			}
 			break;
-		case 'p':
-			sched = &prio_scheduler;
+		case 'A':
+			nr_aging_periods = __parse_params(optarg, aging_periods);
+			if (!nr_aging_periods) {
+				__print_usage(argv[0]);
+				return EXIT_FAILURE;
+			}
 			break;
-		case 'a':
-			sched = &pa_scheduler;
+		case 'K':
+			checkpoint_tick = strtoul(optarg, &end, 10);
+			if (end == optarg || *end != ':' || !end[1]) {
+				__print_usage(argv[0]);
+				return EXIT_FAILURE;
+			}
+			checkpointfile = end + 1;
 			break;
-		case 'i':
-			sched = &pip_scheduler;
+		case 'R':
+			restorefile = optarg;
 			break;
-		case 'c':
-			sched = &pcp_scheduler;
+		case 'I':
+			sample_period = strtoul(optarg, &end, 10);
+			if (end == optarg || !sample_period || *end != ':' || !end[1]) {
+				__print_usage(argv[0]);
+				return EXIT_FAILURE;
+			}
+			samplefilename = end + 1;
 			break;
+
 		case 'h':
-		default:
 			__print_usage(argv[0]);
 			return EXIT_FAILURE;
+		default:
+			/* Scheduler selection (-f, -s, ...) */
+			sched = __find_scheduler(opt);
+			if (!sched) {
+				__print_usage(argv[0]);
+				return EXIT_FAILURE;
+			}
+			sched_selected = true;
+			break;
 		}
 	}
 
-	if (optind >= argc) {
+	/* Sweep more than one parameter only */
+	if ((nr_quanta > 1 || nr_aging_periods > 1) && !sweepflags) {
+		__print_usage(argv[0]);
+		return EXIT_FAILURE;
+	}
+	if (nr_quanta) {
+		rr_quantum = quanta[0];
+	}
+	if (nr_aging_periods) {
+		pa_aging_period = aging_periods[0];
+	}
+
+	/* Checkpoints are of a single simulation */
+	if ((checkpointfile || restorefile) && (sweepflags || workloadfile)) {
+		__print_usage(argv[0]);
+		return EXIT_FAILURE;
+	}
+	resource_stats = print_metrics || checkpointfile;
+	metrics_keep_samples(print_metrics || checkpointfile);
+
+	/* Samples are of a single simulation */
+	if (sample_period && (sweepflags || workloadfile)) {
+		__print_usage(argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	/* Streams are of a single simulation from the start */
+	if (streaming && (checkpointfile || restorefile || sweepflags || workloadfile)) {
+		__print_usage(argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	/* The script is optional to continue from a checkpoint */
+	if (optind < argc) {
+		scriptfile = argv[optind];
+	} else if (!restorefile) {
 		__print_usage(argv[0]);
 		return EXIT_FAILURE;
 	}
 
-	scriptfile = argv[optind];
+	/* Continue with the scheduler and the CPUs in the checkpoint */
+	if (restorefile) {
+		const struct checkpoint_header *header;
+
+		if (!__read_checkpoint(restorefile, &checkpoint)) {
+			return EXIT_FAILURE;
+		}
+		header = checkpoint.header;
+
+		if ((sched_selected && __scheduler_flag(sched) != header->sched) ||
+				(cpus_given && nr_cpus != header->nr_cpus)) {
+			fprintf(stderr, "%s is a checkpoint of -%c with %u CPU(s)\n",
+					restorefile, header->sched, header->nr_cpus);
+			return EXIT_FAILURE;
+		}
+		sched = __find_scheduler(header->sched);
+		nr_cpus = header->nr_cpus;
+
+		/* The tunables may differ from here on */
+		if (!nr_quanta) rr_quantum = header->rr_quantum;
+		if (!nr_aging_periods) pa_aging_period = header->pa_aging_period;
+	}
+
+	if (checkpointfile && !__can_checkpoint(sched)) {
+		fprintf(stderr, "%s scheduler cannot be checkpointed\n", sched->name);
+		return EXIT_FAILURE;
+	}
 
 	__initialize();
 
-	if (!__load_script(scriptfile)) {
+	if (restorefile) {
+		if (!__restore_checkpoint(&checkpoint, scriptfile)) {
+			return EXIT_FAILURE;
+		}
+	} else if (streaming) {
+		if (!__load_stream(scriptfile)) return EXIT_FAILURE;
+	} else if (!__load_script(scriptfile)) {
+		return EXIT_FAILURE;
+	}
+
+	if (workloadfile) {
+		return __save_workload(workloadfile) ? EXIT_SUCCESS : EXIT_FAILURE;
+	}
+
+	if (sweepflags) {
+		return __sweep(sweepflags, quanta, nr_quanta,
+				aging_periods, nr_aging_periods, nr_threads)
+				? EXIT_SUCCESS : EXIT_FAILURE;
+	}
+
+	__layout_cpus();
+
+	if (bench) {
+		/* Time the scheduling, not the output */
+		mute = true;
+		bench_start = __now_ns();
+	}
+
+	if (tracefile && trace_open(tracefile)) {
 		return EXIT_FAILURE;
 	}
 
+	/* Nothing to do with the events at all */
+	if (headless && !tracefile) mute = true;
+
+	if (sample_period) {
+		samplefile = fopen(samplefilename, "w");
+		if (!samplefile) {
+			fprintf(stderr, "Unable to open %s\n", samplefilename);
+			return EXIT_FAILURE;
+		}
+		/* From the first multiple of the period, also on a restored one */
+		__next_sample = (ticks + sample_period - 1) / sample_period * sample_period;
+	}
+
 	if (sched->initialize && sched->initialize()) {
 		return EXIT_FAILURE;
 	}
 
+	if (restorefile) {
+		__restore_cpus(&checkpoint);
+		free(checkpoint.image);
+	}
+
 	__do_simulation();
 
+	if (streaming) {
+		bool failed = __stream.failed;
+
+		__close_stream(&__stream);
+		if (failed) {
+			output_flush();
+			return EXIT_FAILURE;
+		}
+	}
+
+	if (checkpointfile) {
+		bool saved = false;
+
+		output_flush();
+
+		if (ticks != checkpoint_tick) {
+			fprintf(stderr, "The simulation ended at tick %u before the checkpoint\n",
+					ticks);
+		} else {
+			saved = __save_checkpoint(checkpointfile);
+		}
+		trace_close();
+		if (samplefile) fclose(samplefile);
+
+		if (saved && !quiet) {
+			printf("\nCheckpointed at tick %u into %s\n", ticks, checkpointfile);
+		}
+
+		if (sched->finalize) sched->finalize();
+		__finalize_simulation();
+
+		return saved ? EXIT_SUCCESS : EXIT_FAILURE;
+	}
+
+	if (bench) {
+		unsigned long long elapsed = __now_ns() - bench_start;
+
+		printf("%s: %u ticks in %.3f s, %.1f ns/tick, %.1f ns/schedule()\n",
+				sched->name, ticks, elapsed / 1e9,
+				ticks ? (double)elapsed / ticks : 0.0,
+				__nr_schedules ? (double)__schedule_ns / __nr_schedules : 0.0);
+	}
+
+	trace_close();
+	if (samplefile) fclose(samplefile);
+
+	__report_utilization();
+
+	if (print_metrics) {
+		output_flush();
+		metrics_print();
+		metrics_print_resources(ticks);
+	}
+
 	if (sched->finalize) {
 		sched->finalize();
 	}
 
+	__finalize_simulation();
+
 	return EXIT_SUCCESS;
 }
 /*          ******        DO NOT MODIFY THIS FILE        ******       */
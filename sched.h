@@ -16,6 +16,12 @@
 #ifndef __SCHED_H__
 #define __SCHED_H__
 
+/**
+ * Maximum # of CPUs to simulate (-n). The framework calls back schedulers
+ * for one CPU at a time, which is @this_cpu
+ */
+#define MAX_CPUS	64
+
 /***********************************************************************
  * struct scheduler
  *
@@ -73,6 +79,46 @@ struct scheduler {
 	void (*exiting)(struct process *);
 
 
+	/***********************************************************************
+	 * bool admit(struct process *process)
+	 *
+	 * DESCRIPTION
+	 *   Decide whether to let @process in when it is about to fork on
+	 *   @this_cpu. It is called before @process gets into the ready queue.
+	 *   A rejected process is never forked but reported as rejected and
+	 *   freed. Leave it NULL to admit all processes.
+	 *
+	 * RETURN
+	 *   true to fork @process
+	 *   false to reject it
+	 */
+	bool (*admit)(struct process *);
+
+
+	/***********************************************************************
+	 * void enqueue(struct process *process)
+	 *
+	 * DESCRIPTION
+	 *   Put @process into the ready queue of the scheduler. Schedulers that
+	 *   keep their own ready queue structure set this (and @dequeue) so that
+	 *   the framework and the resource callbacks put ready processes there
+	 *   instead of the default @readyqueue. Leave it NULL to use @readyqueue.
+	 *
+	 *   With @enqueue set, @readyqueue stays empty. So @schedule() returning
+	 *   NULL tells the framework that no process is ready to run.
+	 */
+	void (*enqueue)(struct process *);
+
+
+	/***********************************************************************
+	 * void dequeue(struct process *process)
+	 *
+	 * DESCRIPTION
+	 *   Take @process out of the ready queue that @enqueue() put it in.
+	 */
+	void (*dequeue)(struct process *);
+
+
 	/***********************************************************************
 	 * struct process *schedule(void)
 	 *
@@ -91,6 +137,102 @@ struct scheduler {
 	struct process *(*schedule)(void);
 
 
+	/***********************************************************************
+	 * unsigned int timeslice(void)
+	 *
+	 * DESCRIPTION
+	 *   Tell how many upcoming schedule() calls would keep returning @current
+	 *   if nothing else happens in the system (i.e., no process is forked nor
+	 *   woken up). In the event-driven mode (-e), the framework runs @current
+	 *   for that many ticks without calling schedule(), and skips idle ticks
+	 *   without calling schedule() as well. So set this only when schedule()
+	 *   has no side effect in those cases.
+	 *
+	 *   Leave it NULL to have schedule() called on every tick.
+	 *
+	 * RETURN
+	 *   # of ticks @current can keep running. UINT_MAX if unlimited
+	 */
+	unsigned int (*timeslice)(void);
+
+
+	/***********************************************************************
+	 * unsigned int nr_ready(void)
+	 *
+	 * DESCRIPTION
+	 *   Tell how many processes are in the ready queue of @this_cpu. Used to
+	 *   balance the load between CPUs (-n). Schedulers using @readyqueue may
+	 *   leave it NULL to have the framework count @readyqueue.
+	 */
+	unsigned int (*nr_ready)(void);
+
+
+	/***********************************************************************
+	 * struct process *steal(void)
+	 *
+	 * DESCRIPTION
+	 *   Take a process out of the ready queue of @this_cpu to migrate it to
+	 *   another CPU. The framework puts the process into the other CPU with
+	 *   enqueue(). Do not touch @current here as it is not of @this_cpu.
+	 *   Schedulers using @readyqueue may leave it NULL to migrate the first
+	 *   process in @readyqueue. Schedulers keeping their own ready queue
+	 *   should set this to let the framework migrate processes.
+	 *
+	 * RETURN
+	 *   process to migrate
+	 *   NULL if there is no process to migrate
+	 */
+	struct process *(*steal)(void);
+
+
+	/***********************************************************************
+	 * struct process *drain(void)
+	 *
+	 * DESCRIPTION
+	 *   Take a process out of the ready queue of @this_cpu to save it into a
+	 *   checkpoint (-K). Restoring the checkpoint (-R) puts the processes back
+	 *   with enqueue(), or with refill() if set, in the order they were taken
+	 *   out, which should rebuild the ready queue as it was.
+	 *
+	 *   Leave it NULL to drain the ready queue with @steal(). Do so only if
+	 *   putting the processes back in the order @steal() takes them out
+	 *   rebuilds the ready queue. Schedulers using @readyqueue may leave both
+	 *   NULL.
+	 *
+	 * RETURN
+	 *   process to save
+	 *   NULL if the ready queue is empty
+	 */
+	struct process *(*drain)(void);
+
+
+	/***********************************************************************
+	 * void refill(struct process *process)
+	 *
+	 * DESCRIPTION
+	 *   Put @process, which drain() took out, back into the ready queue of
+	 *   @this_cpu on restoring a checkpoint. Set this when enqueue() changes
+	 *   the process in a way it would not have been while it was in the ready
+	 *   queue. Leave it NULL to put the processes back with enqueue().
+	 */
+	void (*refill)(struct process *);
+
+
+	/***********************************************************************
+	 * unsigned int save(void)
+	 * void restore(unsigned int state)
+	 *
+	 * DESCRIPTION
+	 *   Save the state of the scheduler for @this_cpu into a checkpoint, and
+	 *   bring it back on restoring the checkpoint. restore() is called after
+	 *   initialize() and before the ready processes are put back. The ready
+	 *   queue and the processes are saved by the framework, so leave them
+	 *   NULL if the scheduler keeps nothing else.
+	 */
+	unsigned int (*save)(void);
+	void (*restore)(unsigned int);
+
+
 	/***********************************************************************
 	 * bool acquire(int resource_id)
 	 *
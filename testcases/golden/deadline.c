@@ -0,0 +1,50 @@
+  0:         N
+  0:                 N
+  0:         +0
+  0:         2
+  1:     N
+  1:                 4
+  2:             N
+  2:     1
+  3:                     N
+  3:         2
+  4:             3
+  5:                 4
+  6:                     5
+  7:     =
+  8:         2
+  9:             3
+ 10:                 4
+ 11:                 X
+ 11:                     5
+ 12:         2
+ 12:         -0
+ 13:             3
+ 14:                         N
+ 14:             X
+ 14:                     5
+ 15:                             N
+ 15:     +0
+ 15:     1
+ 16:         2
+ 17:         X
+ 17:                         6
+ 18:                             +1
+ 18:                             7
+ 19:                     5
+ 20:                     X
+ 20:     1
+ 20:     -0
+ 21:                         =
+ 22:                             7
+ 23:     1
+ 24:     X
+ 24:                             7
+ 24:                             -1
+ 25:                             X
+ 25:                         +1
+ 25:                         6
+ 26:                         6
+ 26:                         -1
+ 27:                         6
+ 28:                         X
@@ -0,0 +1,48 @@
+  0:         N
+  0:                 N
+  0:         +0
+  0:         2
+  1:     N
+  1:         2
+  2:             N
+  2:         2
+  3:                     N
+  3:         2
+  3:         -0
+  4:         2
+  5:         X
+  5:                 4
+  6:                 4
+  7:                 4
+  8:                 X
+  8:     1
+  9:     +0
+  9:     1
+ 10:     1
+ 10:     -0
+ 11:     1
+ 12:     X
+ 12:             3
+ 13:             3
+ 14:                         N
+ 14:             3
+ 15:                             N
+ 15:             X
+ 15:                     5
+ 16:                     5
+ 17:                     5
+ 18:                     5
+ 19:                     X
+ 19:                         6
+ 20:                         +1
+ 20:                         6
+ 21:                         6
+ 21:                         -1
+ 22:                         6
+ 23:                         X
+ 23:                             +1
+ 23:                             7
+ 24:                             7
+ 25:                             7
+ 25:                             -1
+ 26:                             X
@@ -0,0 +1,50 @@
+  0:         N
+  0:                 N
+  0:         +0
+  0:         2
+  1:     N
+  1:                 4
+  2:             N
+  2:     1
+  3:                     N
+  3:             3
+  4:                     5
+  5:         2
+  6:         2
+  7:                 4
+  8:                 4
+  9:                 X
+  9:     =
+ 10:             3
+ 11:             3
+ 12:             X
+ 12:                     5
+ 13:                     5
+ 14:                         N
+ 14:                         6
+ 15:                             N
+ 15:                             +1
+ 15:                             7
+ 16:                         =
+ 17:                             7
+ 18:                             7
+ 18:                             -1
+ 19:                             X
+ 19:                         +1
+ 19:                         6
+ 20:                         6
+ 20:                         -1
+ 21:         2
+ 21:         -0
+ 22:     +0
+ 22:     1
+ 23:     1
+ 23:     -0
+ 24:                     5
+ 25:                     X
+ 25:                         6
+ 26:                         X
+ 26:         2
+ 27:         X
+ 27:     1
+ 28:     X
@@ -0,0 +1,49 @@
+  0:         N
+  0:                 N
+  0:         +0
+  0:         2
+  1:     N
+  1:                 4
+  2:             N
+  2:                 4
+  3:                     N
+  3:                 4
+  4:                 X
+  4:         2
+  5:         2
+  6:         2
+  6:         -0
+  7:         2
+  8:         X
+  8:     1
+  9:     +0
+  9:     1
+ 10:             3
+ 11:             3
+ 12:             3
+ 13:             X
+ 13:                     5
+ 14:                         N
+ 14:                     5
+ 15:                             N
+ 15:                     5
+ 16:                     5
+ 17:                     X
+ 17:     1
+ 17:     -0
+ 18:     1
+ 19:     X
+ 19:                         6
+ 20:                         +1
+ 20:                         6
+ 21:                             =
+ 22:                         6
+ 22:                         -1
+ 23:                         6
+ 24:                         X
+ 24:                             +1
+ 24:                             7
+ 25:                             7
+ 26:                             7
+ 26:                             -1
+ 27:                             X
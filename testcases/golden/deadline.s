@@ -0,0 +1,48 @@
+  0:         N
+  0:                 N
+  0:                 4
+  1:     N
+  1:                 4
+  2:             N
+  2:                 4
+  3:                     N
+  3:                 X
+  3:             3
+  4:             3
+  5:             3
+  6:             X
+  6:     1
+  7:     +0
+  7:     1
+  8:     1
+  8:     -0
+  9:     1
+ 10:     X
+ 10:                     5
+ 11:                     5
+ 12:                     5
+ 13:                     5
+ 14:                         N
+ 14:                     X
+ 14:                         6
+ 15:                             N
+ 15:                         +1
+ 15:                         6
+ 16:                         6
+ 16:                         -1
+ 17:                         6
+ 18:                         X
+ 18:                             +1
+ 18:                             7
+ 19:                             7
+ 20:                             7
+ 20:                             -1
+ 21:                             X
+ 21:         +0
+ 21:         2
+ 22:         2
+ 23:         2
+ 24:         2
+ 24:         -0
+ 25:         2
+ 26:         X
@@ -0,0 +1,44 @@
+  0:         N
+  0:                 N
+  0:         +0
+  0:         2
+  1:     N
+  1:     1
+  2:             N
+  2:     =
+  3:                     R
+  3:         2
+  4:         2
+  5:         2
+  5:         -0
+  6:     +0
+  6:     1
+  7:     1
+  7:     -0
+  8:     1
+  9:     X
+  9:             3
+ 10:             3
+ 11:             3
+ 12:             X
+ 12:         2
+ 13:         X
+ 13:                 4
+ 14:                         N
+ 14:                         6
+ 15:                             N
+ 15:                         +1
+ 15:                         6
+ 16:                         6
+ 16:                         -1
+ 17:                         6
+ 18:                         X
+ 18:                             +1
+ 18:                             7
+ 19:                             7
+ 20:                             7
+ 20:                             -1
+ 21:                             X
+ 21:                 4
+ 22:                 4
+ 23:                 X
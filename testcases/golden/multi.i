@@ -0,0 +1,35 @@
+  0:     N
+  0:         N
+  0:             N
+  0:                 N
+  0:     1
+  1:                     N
+  1:         2
+  2:             3
+  3:                 4
+  4:                     5
+  5:                     X
+  5:     1
+  6:         2
+  7:             3
+  8:                 4
+  9:     1
+ 10:     X
+ 10:         2
+ 11:             3
+ 12:                 4
+ 13:                 X
+ 13:         2
+ 14:             3
+ 15:         2
+ 16:             3
+ 17:         2
+ 18:             3
+ 19:         2
+ 20:             3
+ 21:         2
+ 22:             3
+ 23:             X
+ 23:         2
+ 24:         2
+ 25:         X
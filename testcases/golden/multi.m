@@ -0,0 +1,35 @@
+  0:     N
+  0:         N
+  0:             N
+  0:                 N
+  0:     1
+  1:                     N
+  1:         2
+  2:             3
+  3:                 4
+  4:                     5
+  5:                     X
+  5:     1
+  6:     1
+  7:     X
+  7:         2
+  8:         2
+  9:             3
+ 10:             3
+ 11:                 4
+ 12:                 4
+ 13:                 X
+ 13:         2
+ 14:         2
+ 15:         2
+ 16:         2
+ 17:             3
+ 18:             3
+ 19:             3
+ 20:             3
+ 21:         2
+ 22:         2
+ 23:         2
+ 24:         X
+ 24:             3
+ 25:             X
@@ -0,0 +1,35 @@
+  0:     N
+  0:         N
+  0:             N
+  0:                 N
+  0:     1
+  1:                     N
+  1:     1
+  2:     1
+  3:     X
+  3:         2
+  4:         2
+  5:         2
+  6:         2
+  7:         2
+  8:         2
+  9:         2
+ 10:         2
+ 11:         2
+ 12:         2
+ 13:         X
+ 13:             3
+ 14:             3
+ 15:             3
+ 16:             3
+ 17:             3
+ 18:             3
+ 19:             3
+ 20:             3
+ 21:             X
+ 21:                 4
+ 22:                 4
+ 23:                 4
+ 24:                 X
+ 24:                     5
+ 25:                     X
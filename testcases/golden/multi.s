@@ -0,0 +1,35 @@
+  0:     N
+  0:         N
+  0:             N
+  0:                 N
+  0:     1
+  1:                     N
+  1:     1
+  2:     1
+  3:     X
+  3:                     5
+  4:                     X
+  4:                 4
+  5:                 4
+  6:                 4
+  7:                 X
+  7:             3
+  8:             3
+  9:             3
+ 10:             3
+ 11:             3
+ 12:             3
+ 13:             3
+ 14:             3
+ 15:             X
+ 15:         2
+ 16:         2
+ 17:         2
+ 18:         2
+ 19:         2
+ 20:         2
+ 21:         2
+ 22:         2
+ 23:         2
+ 24:         2
+ 25:         X
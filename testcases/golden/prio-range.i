@@ -0,0 +1,24 @@
+  0:     N
+  0:     1
+  1:         N
+  1:         2
+  2:             N
+  2:                 N
+  2:         +0
+  2:         2
+  3:         2
+  3:         -0
+  4:         2
+  5:         X
+  5:             +0
+  5:             3
+  6:             3
+  6:             -0
+  7:             3
+  8:             X
+  8:                 4
+  9:                 4
+ 10:                 X
+ 10:     1
+ 11:     1
+ 12:     X
@@ -0,0 +1,25 @@
+  0:     N
+  0:     1
+  1:         N
+  1:         2
+  2:             N
+  2:                 N
+  2:             +0
+  2:             3
+  3:                 4
+  4:     1
+  5:     1
+  6:     X
+  6:         =
+  7:             3
+  7:             -0
+  8:             3
+  9:             X
+  9:                 4
+ 10:                 X
+ 10:         +0
+ 10:         2
+ 11:         2
+ 11:         -0
+ 12:         2
+ 13:         X
@@ -0,0 +1,25 @@
+  0:     N
+  0:     1
+  1:         N
+  1:     1
+  2:             N
+  2:                 N
+  2:     1
+  3:     X
+  3:         2
+  4:         +0
+  4:         2
+  5:             =
+  6:                 4
+  7:                 4
+  8:                 X
+  8:         2
+  8:         -0
+  9:         2
+ 10:         X
+ 10:             +0
+ 10:             3
+ 11:             3
+ 11:             -0
+ 12:             3
+ 13:             X
@@ -0,0 +1,25 @@
+  0:     N
+  0:     1
+  1:         N
+  1:         2
+  2:             N
+  2:                 N
+  2:     1
+  3:             +0
+  3:             3
+  4:                 4
+  5:         =
+  6:     1
+  7:     X
+  7:             3
+  7:             -0
+  8:                 4
+  9:                 X
+  9:         +0
+  9:         2
+ 10:             3
+ 11:             X
+ 11:         2
+ 11:         -0
+ 12:         2
+ 13:         X
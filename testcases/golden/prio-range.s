@@ -0,0 +1,24 @@
+  0:     N
+  0:     1
+  1:         N
+  1:     1
+  2:             N
+  2:                 N
+  2:     1
+  3:     X
+  3:                 4
+  4:                 4
+  5:                 X
+  5:             +0
+  5:             3
+  6:             3
+  6:             -0
+  7:             3
+  8:             X
+  8:         2
+  9:         +0
+  9:         2
+ 10:         2
+ 10:         -0
+ 11:         2
+ 12:         X
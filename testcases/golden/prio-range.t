@@ -0,0 +1,24 @@
+  0:     N
+  0:     1
+  1:         N
+  1:     1
+  2:             N
+  2:                 N
+  2:     1
+  3:     X
+  3:         2
+  4:         +0
+  4:         2
+  5:         2
+  5:         -0
+  6:         2
+  7:         X
+  7:             +0
+  7:             3
+  8:             3
+  8:             -0
+  9:             3
+ 10:             X
+ 10:                 4
+ 11:                 4
+ 12:                 X
@@ -0,0 +1,36 @@
+  0:     N
+  0:         N
+  0:             N
+  0:                 N
+  0:                     N
+  0:                         N
+  0:     1
+  1:         2
+  2:             3
+  3:                 4
+  4:                     5
+  5:                         6
+  6:     1
+  7:     1
+  8:         2
+  9:         2
+ 10:             3
+ 11:             3
+ 12:                 4
+ 13:                 4
+ 14:                     5
+ 15:                     5
+ 16:                         6
+ 17:                         6
+ 18:     1
+ 19:     X
+ 19:         2
+ 20:         X
+ 20:             3
+ 21:             X
+ 21:                 4
+ 22:                 X
+ 22:                     5
+ 23:                     X
+ 23:                         6
+ 24:                         X
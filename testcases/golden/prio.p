@@ -0,0 +1,36 @@
+  0:     N
+  0:         N
+  0:             N
+  0:                 N
+  0:                     N
+  0:                         N
+  0:                     5
+  1:                     5
+  2:                     5
+  3:                     5
+  4:                     X
+  4:         2
+  5:         2
+  6:         2
+  7:         2
+  8:         X
+  8:             3
+  9:             3
+ 10:             3
+ 11:             3
+ 12:             X
+ 12:     1
+ 13:     1
+ 14:     1
+ 15:     1
+ 16:     X
+ 16:                 4
+ 17:                 4
+ 18:                 4
+ 19:                 4
+ 20:                 X
+ 20:                         6
+ 21:                         6
+ 22:                         6
+ 23:                         6
+ 24:                         X
@@ -0,0 +1,36 @@
+  0:     N
+  0:         N
+  0:             N
+  0:                 N
+  0:                     N
+  0:                         N
+  0:     1
+  1:         2
+  2:             3
+  3:                 4
+  4:                     5
+  5:                         6
+  6:     1
+  7:         2
+  8:             3
+  9:                 4
+ 10:                     5
+ 11:                         6
+ 12:     1
+ 13:         2
+ 14:             3
+ 15:                 4
+ 16:                     5
+ 17:                         6
+ 18:     1
+ 19:     X
+ 19:         2
+ 20:         X
+ 20:             3
+ 21:             X
+ 21:                 4
+ 22:                 X
+ 22:                     5
+ 23:                     X
+ 23:                         6
+ 24:                         X
@@ -0,0 +1,36 @@
+  0:     N
+  0:         N
+  0:             N
+  0:                 N
+  0:                     N
+  0:                         N
+  0:     1
+  1:     1
+  2:     1
+  3:     1
+  4:     X
+  4:         2
+  5:         2
+  6:         2
+  7:         2
+  8:         X
+  8:             3
+  9:             3
+ 10:             3
+ 11:             3
+ 12:             X
+ 12:                 4
+ 13:                 4
+ 14:                 4
+ 15:                 4
+ 16:                 X
+ 16:                     5
+ 17:                     5
+ 18:                     5
+ 19:                     5
+ 20:                     X
+ 20:                         6
+ 21:                         6
+ 22:                         6
+ 23:                         6
+ 24:                         X
@@ -0,0 +1,34 @@
+  0:     N
+  0:     1
+  1:     1
+  2:     +1
+  2:     1
+  3:         N
+  3:         =
+  4:     1
+  5:             N
+  5:     1
+  6:     1
+  6:     -1
+  7:         +1
+  7:         2
+  8:         2
+  9:         2
+ 10:         2
+ 10:         -1
+ 11:         2
+ 12:         X
+ 12:             3
+ 13:             3
+ 14:             +1
+ 14:             3
+ 15:             3
+ 16:             3
+ 17:             3
+ 17:             -1
+ 18:             X
+ 18:     1
+ 19:     1
+ 20:     1
+ 21:     1
+ 22:     X
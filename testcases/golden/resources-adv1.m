@@ -0,0 +1,35 @@
+  0:     N
+  0:     1
+  1:     1
+  2:     +1
+  2:     1
+  3:         N
+  3:         =
+  4:     1
+  5:             N
+  5:             3
+  6:             3
+  7:             =
+  8:     1
+  9:     1
+  9:     -1
+ 10:         +1
+ 10:         2
+ 11:         2
+ 12:         2
+ 13:     1
+ 14:         2
+ 14:         -1
+ 15:             +1
+ 15:             3
+ 16:         2
+ 17:         X
+ 17:             3
+ 18:             3
+ 19:             3
+ 19:             -1
+ 20:             X
+ 20:     1
+ 21:     1
+ 22:     1
+ 23:     X
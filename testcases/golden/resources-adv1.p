@@ -0,0 +1,34 @@
+  0:     N
+  0:     1
+  1:     1
+  2:     +1
+  2:     1
+  3:         N
+  3:         =
+  4:     1
+  5:             N
+  5:     1
+  6:     1
+  6:     -1
+  7:     1
+  8:     1
+  9:     1
+ 10:     1
+ 11:     X
+ 11:         +1
+ 11:         2
+ 12:         2
+ 13:         2
+ 14:         2
+ 14:         -1
+ 15:         2
+ 16:         X
+ 16:             3
+ 17:             3
+ 18:             +1
+ 18:             3
+ 19:             3
+ 20:             3
+ 21:             3
+ 21:             -1
+ 22:             X
@@ -0,0 +1,35 @@
+  0:     N
+  0:     1
+  1:     1
+  2:     +1
+  2:     1
+  3:         N
+  3:         =
+  4:     1
+  5:             N
+  5:             3
+  6:     1
+  7:             3
+  8:     1
+  8:     -1
+  9:             +1
+  9:             3
+ 10:         =
+ 11:     1
+ 12:             3
+ 13:     1
+ 14:             3
+ 15:     1
+ 16:             3
+ 16:             -1
+ 17:             X
+ 17:     1
+ 18:     X
+ 18:         +1
+ 18:         2
+ 19:         2
+ 20:         2
+ 21:         2
+ 21:         -1
+ 22:         2
+ 23:         X
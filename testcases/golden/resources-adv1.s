@@ -0,0 +1,33 @@
+  0:     N
+  0:     1
+  1:     1
+  2:     +1
+  2:     1
+  3:         N
+  3:     1
+  4:     1
+  5:             N
+  5:     1
+  5:     -1
+  6:     1
+  7:     1
+  8:     1
+  9:     1
+ 10:     X
+ 10:         +1
+ 10:         2
+ 11:         2
+ 12:         2
+ 13:         2
+ 13:         -1
+ 14:         2
+ 15:         X
+ 15:             3
+ 16:             3
+ 17:             +1
+ 17:             3
+ 18:             3
+ 19:             3
+ 20:             3
+ 20:             -1
+ 21:             X
@@ -0,0 +1,36 @@
+  0:     N
+  0:     +1
+  0:     +2
+  0:     +3
+  0:     +4
+  0:     1
+  1:         N
+  1:     1
+  1:     -1
+  2:             N
+  2:                 N
+  2:                 +1
+  2:                 4
+  2:                 -1
+  3:                 X
+  3:             3
+  4:     1
+  4:     -2
+  5:             3
+  6:             +2
+  6:             3
+  7:             3
+  7:             -2
+  8:             X
+  8:         +1
+  8:         2
+  9:         +2
+  9:         2
+  9:         -1
+  9:         -2
+ 10:         2
+ 11:         X
+ 11:     1
+ 11:     -3
+ 11:     -4
+ 12:     X
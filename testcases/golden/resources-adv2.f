@@ -0,0 +1,36 @@
+  0:     N
+  0:     +1
+  0:     +2
+  0:     +3
+  0:     +4
+  0:     1
+  1:         N
+  1:     1
+  1:     -1
+  2:             N
+  2:                 N
+  2:     1
+  2:     -2
+  3:     1
+  3:     -3
+  3:     -4
+  4:     X
+  4:         +1
+  4:         2
+  5:         +2
+  5:         2
+  5:         -1
+  5:         -2
+  6:         2
+  7:         X
+  7:             3
+  8:             3
+  9:             +2
+  9:             3
+ 10:             3
+ 10:             -2
+ 11:             X
+ 11:                 +1
+ 11:                 4
+ 11:                 -1
+ 12:                 X
@@ -0,0 +1,39 @@
+  0:     N
+  0:     +1
+  0:     +2
+  0:     +3
+  0:     +4
+  0:     1
+  1:         N
+  1:         =
+  2:             N
+  2:                 N
+  2:                 =
+  3:     1
+  3:     -1
+  4:                 +1
+  4:                 4
+  4:                 -1
+  5:                 X
+  5:             3
+  6:             3
+  7:             =
+  8:     1
+  8:     -2
+  9:             +2
+  9:             3
+ 10:             3
+ 10:             -2
+ 11:             X
+ 11:         +1
+ 11:         2
+ 12:         +2
+ 12:         2
+ 12:         -1
+ 12:         -2
+ 13:         2
+ 14:         X
+ 14:     1
+ 14:     -3
+ 14:     -4
+ 15:     X
@@ -0,0 +1,39 @@
+  0:     N
+  0:     +1
+  0:     +2
+  0:     +3
+  0:     +4
+  0:     1
+  1:         N
+  1:         =
+  2:             N
+  2:                 N
+  2:             3
+  3:                 =
+  4:     1
+  4:     -1
+  5:         +1
+  5:         2
+  6:             3
+  7:             =
+  8:     1
+  8:     -2
+  9:         +2
+  9:         2
+  9:         -1
+  9:         -2
+ 10:                 +1
+ 10:                 4
+ 10:                 -1
+ 11:                 X
+ 11:             +2
+ 11:             3
+ 12:         2
+ 13:         X
+ 13:     1
+ 13:     -3
+ 13:     -4
+ 14:     X
+ 14:             3
+ 14:             -2
+ 15:             X
@@ -0,0 +1,39 @@
+  0:     N
+  0:     +1
+  0:     +2
+  0:     +3
+  0:     +4
+  0:     1
+  1:         N
+  1:         =
+  2:             N
+  2:                 N
+  2:                 =
+  3:             3
+  4:             3
+  5:             =
+  6:     1
+  6:     -1
+  7:     1
+  7:     -2
+  8:     1
+  8:     -3
+  8:     -4
+  9:     X
+  9:                 +1
+  9:                 4
+  9:                 -1
+ 10:                 X
+ 10:             +2
+ 10:             3
+ 11:             3
+ 11:             -2
+ 12:             X
+ 12:         +1
+ 12:         2
+ 13:         +2
+ 13:         2
+ 13:         -1
+ 13:         -2
+ 14:         2
+ 15:         X
@@ -0,0 +1,37 @@
+  0:     N
+  0:     +1
+  0:     +2
+  0:     +3
+  0:     +4
+  0:     1
+  1:         N
+  1:         =
+  2:             N
+  2:                 N
+  2:     1
+  2:     -1
+  3:             3
+  4:                 +1
+  4:                 4
+  4:                 -1
+  5:                 X
+  5:         +1
+  5:         2
+  6:     1
+  6:     -2
+  7:             3
+  8:         +2
+  8:         2
+  8:         -1
+  8:         -2
+  9:     1
+  9:     -3
+  9:     -4
+ 10:     X
+ 10:             +2
+ 10:             3
+ 11:         2
+ 12:         X
+ 12:             3
+ 12:             -2
+ 13:             X
@@ -0,0 +1,36 @@
+  0:     N
+  0:     +1
+  0:     +2
+  0:     +3
+  0:     +4
+  0:     1
+  1:         N
+  1:     1
+  1:     -1
+  2:             N
+  2:                 N
+  2:     1
+  2:     -2
+  3:     1
+  3:     -3
+  3:     -4
+  4:     X
+  4:                 +1
+  4:                 4
+  4:                 -1
+  5:                 X
+  5:         +1
+  5:         2
+  6:         +2
+  6:         2
+  6:         -1
+  6:         -2
+  7:         2
+  8:         X
+  8:             3
+  9:             3
+ 10:             +2
+ 10:             3
+ 11:             3
+ 11:             -2
+ 12:             X
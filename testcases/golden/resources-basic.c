@@ -0,0 +1,48 @@
+  0:     N
+  0:         N
+  0:     1
+  1:         2
+  2:     1
+  3:             N
+  3:             +1
+  3:             3
+  4:             3
+  4:             -1
+  5:             3
+  6:             3
+  7:             +1
+  7:             3
+  8:             3
+  8:             -1
+  9:             3
+ 10:             3
+ 11:             X
+ 11:         2
+ 12:     +1
+ 12:     1
+ 13:     1
+ 13:     -1
+ 14:         +1
+ 14:         2
+ 15:         2
+ 15:         -1
+ 16:     1
+ 17:         +1
+ 17:         2
+ 18:         2
+ 18:         -1
+ 19:     1
+ 20:         +1
+ 20:         2
+ 21:         2
+ 21:         -1
+ 22:     +1
+ 22:     1
+ 23:     1
+ 23:     -1
+ 24:         2
+ 25:     1
+ 26:         2
+ 27:         X
+ 27:     1
+ 28:     X
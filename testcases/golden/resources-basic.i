@@ -0,0 +1,51 @@
+  0:     N
+  0:         N
+  0:     1
+  1:         2
+  2:     1
+  3:             N
+  3:             +1
+  3:             3
+  4:             3
+  4:             -1
+  5:             3
+  6:             3
+  7:             +1
+  7:             3
+  8:             3
+  8:             -1
+  9:             3
+ 10:             3
+ 11:             X
+ 11:         2
+ 12:     +1
+ 12:     1
+ 13:         =
+ 14:     1
+ 14:     -1
+ 15:         +1
+ 15:         2
+ 16:     1
+ 17:         2
+ 17:         -1
+ 18:     1
+ 19:         +1
+ 19:         2
+ 20:     =
+ 21:         2
+ 21:         -1
+ 22:     +1
+ 22:     1
+ 23:         =
+ 24:     1
+ 24:     -1
+ 25:         +1
+ 25:         2
+ 26:     1
+ 27:         2
+ 27:         -1
+ 28:     1
+ 29:     X
+ 29:         2
+ 30:         2
+ 31:         X
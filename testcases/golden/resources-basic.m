@@ -0,0 +1,54 @@
+  0:     N
+  0:         N
+  0:     1
+  1:         2
+  2:     1
+  3:             N
+  3:             +1
+  3:             3
+  4:         2
+  5:         =
+  6:     =
+  7:             3
+  7:             -1
+  8:             3
+  9:         +1
+  9:         2
+ 10:             3
+ 11:             =
+ 12:         2
+ 12:         -1
+ 13:     +1
+ 13:     1
+ 14:         =
+ 15:     1
+ 15:     -1
+ 16:     1
+ 17:     1
+ 18:     +1
+ 18:     1
+ 19:             =
+ 20:     1
+ 20:     -1
+ 21:         +1
+ 21:         2
+ 22:         2
+ 22:         -1
+ 23:         +1
+ 23:         2
+ 24:             =
+ 25:     1
+ 26:     1
+ 27:     X
+ 27:         2
+ 27:         -1
+ 28:             +1
+ 28:             3
+ 29:             3
+ 29:             -1
+ 30:             3
+ 31:         2
+ 32:         2
+ 33:         X
+ 33:             3
+ 34:             X
@@ -0,0 +1,51 @@
+  0:     N
+  0:         N
+  0:     1
+  1:     1
+  2:     +1
+  2:     1
+  3:             N
+  3:             =
+  4:         2
+  5:         2
+  6:         =
+  7:     1
+  7:     -1
+  8:     1
+  9:     1
+ 10:     +1
+ 10:     1
+ 11:             =
+ 12:     1
+ 12:     -1
+ 13:     1
+ 14:     1
+ 15:     X
+ 15:             +1
+ 15:             3
+ 16:             3
+ 16:             -1
+ 17:             3
+ 18:             3
+ 19:             +1
+ 19:             3
+ 20:             3
+ 20:             -1
+ 21:             3
+ 22:             3
+ 23:             X
+ 23:         +1
+ 23:         2
+ 24:         2
+ 24:         -1
+ 25:         +1
+ 25:         2
+ 26:         2
+ 26:         -1
+ 27:         +1
+ 27:         2
+ 28:         2
+ 28:         -1
+ 29:         2
+ 30:         2
+ 31:         X
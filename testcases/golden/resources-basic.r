@@ -0,0 +1,54 @@
+  0:     N
+  0:         N
+  0:     1
+  1:         2
+  2:     1
+  3:             N
+  3:         2
+  4:             +1
+  4:             3
+  5:     =
+  6:         =
+  7:             3
+  7:             -1
+  8:     +1
+  8:     1
+  9:             3
+ 10:     1
+ 10:     -1
+ 11:             3
+ 12:         +1
+ 12:         2
+ 13:     1
+ 14:             =
+ 15:         2
+ 15:         -1
+ 16:     1
+ 17:             +1
+ 17:             3
+ 18:         =
+ 19:     =
+ 20:             3
+ 20:             -1
+ 21:         +1
+ 21:         2
+ 22:             3
+ 23:         2
+ 23:         -1
+ 24:             3
+ 25:             X
+ 25:     +1
+ 25:     1
+ 26:         =
+ 27:     1
+ 27:     -1
+ 28:         +1
+ 28:         2
+ 29:     1
+ 30:         2
+ 30:         -1
+ 31:     1
+ 32:     X
+ 32:         2
+ 33:         2
+ 34:         X
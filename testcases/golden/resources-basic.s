@@ -0,0 +1,48 @@
+  0:     N
+  0:         N
+  0:     1
+  1:     1
+  2:     +1
+  2:     1
+  3:             N
+  3:     1
+  3:     -1
+  4:     1
+  5:     1
+  6:     +1
+  6:     1
+  7:     1
+  7:     -1
+  8:     1
+  9:     1
+ 10:     X
+ 10:             +1
+ 10:             3
+ 11:             3
+ 11:             -1
+ 12:             3
+ 13:             3
+ 14:             +1
+ 14:             3
+ 15:             3
+ 15:             -1
+ 16:             3
+ 17:             3
+ 18:             X
+ 18:         2
+ 19:         2
+ 20:         +1
+ 20:         2
+ 21:         2
+ 21:         -1
+ 22:         +1
+ 22:         2
+ 23:         2
+ 23:         -1
+ 24:         +1
+ 24:         2
+ 25:         2
+ 25:         -1
+ 26:         2
+ 27:         2
+ 28:         X
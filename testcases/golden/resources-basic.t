@@ -0,0 +1,48 @@
+  0:     N
+  0:         N
+  0:     1
+  1:     1
+  2:     +1
+  2:     1
+  3:             N
+  3:     1
+  3:     -1
+  4:     1
+  5:     1
+  6:     +1
+  6:     1
+  7:     1
+  7:     -1
+  8:     1
+  9:     1
+ 10:     X
+ 10:         2
+ 11:         2
+ 12:         +1
+ 12:         2
+ 13:         2
+ 13:         -1
+ 14:         +1
+ 14:         2
+ 15:         2
+ 15:         -1
+ 16:         +1
+ 16:         2
+ 17:         2
+ 17:         -1
+ 18:         2
+ 19:         2
+ 20:         X
+ 20:             +1
+ 20:             3
+ 21:             3
+ 21:             -1
+ 22:             3
+ 23:             3
+ 24:             +1
+ 24:             3
+ 25:             3
+ 25:             -1
+ 26:             3
+ 27:             3
+ 28:             X
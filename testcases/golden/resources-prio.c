@@ -0,0 +1,28 @@
+  0:     N
+  0:     1
+  1:     +1
+  1:     1
+  2:         N
+  2:     1
+  3:             N
+  3:             3
+  4:     1
+  5:             =
+  6:     1
+  6:     -1
+  7:     X
+  7:             +1
+  7:             3
+  8:             3
+  8:             -1
+  9:             3
+ 10:             3
+ 11:             X
+ 11:         +1
+ 11:         2
+ 12:         2
+ 12:         -1
+ 13:         2
+ 14:         2
+ 15:         2
+ 16:         X
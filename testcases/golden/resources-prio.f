@@ -0,0 +1,27 @@
+  0:     N
+  0:     1
+  1:     +1
+  1:     1
+  2:         N
+  2:     1
+  3:             N
+  3:     1
+  4:     1
+  4:     -1
+  5:     X
+  5:         +1
+  5:         2
+  6:         2
+  6:         -1
+  7:         2
+  8:         2
+  9:         2
+ 10:         X
+ 10:             3
+ 11:             +1
+ 11:             3
+ 12:             3
+ 12:             -1
+ 13:             3
+ 14:             3
+ 15:             X
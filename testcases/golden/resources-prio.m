@@ -0,0 +1,29 @@
+  0:     N
+  0:     1
+  1:     +1
+  1:     1
+  2:         N
+  2:         =
+  3:             N
+  3:             3
+  4:     1
+  5:             =
+  6:     1
+  7:     1
+  7:     -1
+  8:     X
+  8:         +1
+  8:         2
+  9:         2
+  9:         -1
+ 10:         2
+ 11:             +1
+ 11:             3
+ 12:             3
+ 12:             -1
+ 13:         2
+ 14:         2
+ 15:         X
+ 15:             3
+ 16:             3
+ 17:             X
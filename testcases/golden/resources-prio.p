@@ -0,0 +1,29 @@
+  0:     N
+  0:     1
+  1:     +1
+  1:     1
+  2:         N
+  2:         =
+  3:             N
+  3:             3
+  4:             =
+  5:     1
+  6:     1
+  7:     1
+  7:     -1
+  8:     X
+  8:             +1
+  8:             3
+  9:             3
+  9:             -1
+ 10:             3
+ 11:             3
+ 12:             X
+ 12:         +1
+ 12:         2
+ 13:         2
+ 13:         -1
+ 14:         2
+ 15:         2
+ 16:         2
+ 17:         X
@@ -0,0 +1,29 @@
+  0:     N
+  0:     1
+  1:     +1
+  1:     1
+  2:         N
+  2:         =
+  3:             N
+  3:     1
+  4:             3
+  5:     1
+  6:             =
+  7:     1
+  7:     -1
+  8:     X
+  8:         +1
+  8:         2
+  9:         2
+  9:         -1
+ 10:             +1
+ 10:             3
+ 11:         2
+ 12:             3
+ 12:             -1
+ 13:         2
+ 14:             3
+ 15:         2
+ 16:         X
+ 16:             3
+ 17:             X
@@ -0,0 +1,20 @@
+  0:     N
+  0:     1
+  1:     1
+  2:     1
+  3:     1
+  4:     X
+  4: idle
+  5:         N
+  5:         2
+  6:         2
+  7:         2
+  8:         2
+  9:         X
+  9: idle
+ 10:             N
+ 10:             3
+ 11:             3
+ 12:             3
+ 13:             3
+ 14:             X
@@ -0,0 +1,136 @@
+/**********************************************************************
+ * Copyright (c) 2019-2021
+ *  Sang-Hoon Kim <sanghoonkim@ajou.ac.kr>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTIABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ **********************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "trace.h"
+#include "output.h"
+
+/* # of records to buffer before writing them to the trace file */
+#define TRACE_RING_SIZE	(1 << 16)
+
+static int __trace_fd = -1;
+
+static unsigned int __cpu_width = 0;
+
+static struct trace_record __ring[TRACE_RING_SIZE];
+static unsigned int __nr_records = 0;
+
+static void __trace_write(const void *data, size_t len)
+{
+	const char *pos = data;
+
+	while (len) {
+		ssize_t written = write(__trace_fd, pos, len);
+		if (written < 0) {
+			if (errno == EINTR) continue;
+			perror("trace");
+			return;
+		}
+		pos += written;
+		len -= written;
+	}
+}
+
+static void __trace_flush(void)
+{
+	__trace_write(__ring, sizeof(*__ring) * __nr_records);
+	__nr_records = 0;
+}
+
+int trace_open(const char *filename)
+{
+	struct trace_header header = {
+		.magic = TRACE_MAGIC,
+		.cpu_width = __cpu_width,
+	};
+
+	__trace_fd = open(filename, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if (__trace_fd < 0) {
+		fprintf(stderr, "Unable to open %s\n", filename);
+		return -1;
+	}
+
+	__trace_write(&header, sizeof(header));
+	return 0;
+}
+
+void trace_close(void)
+{
+	if (__trace_fd < 0) return;
+
+	__trace_flush();
+	close(__trace_fd);
+	__trace_fd = -1;
+}
+
+void trace_emit(const struct trace_record *record)
+{
+	if (__trace_fd < 0) return;
+
+	__ring[__nr_records++] = *record;
+	if (__nr_records == TRACE_RING_SIZE) {
+		__trace_flush();
+	}
+}
+
+void trace_set_cpu_width(unsigned int cpu_width)
+{
+	__cpu_width = cpu_width;
+}
+
+void trace_render(const struct trace_record *r)
+{
+	output_printf("%3d: ", r->tick);
+
+	if (r->kind == TRACE_IDLE) {
+		output_indent(r->cpu * __cpu_width * 4);
+		output_write("idle\n", 5);
+		return;
+	}
+
+	output_indent((r->cpu * __cpu_width + r->pid) * 4);
+
+	switch (r->kind) {
+	case TRACE_FORK:
+		output_write("N\n", 2);
+		break;
+	case TRACE_EXIT:
+		output_write("X\n", 2);
+		break;
+	case TRACE_RUN:
+		output_printf("%d\n", r->pid);
+		break;
+	case TRACE_BLOCK:
+		output_write("=\n", 2);
+		break;
+	case TRACE_ACQUIRE:
+		output_printf("+%d\n", r->arg);
+		break;
+	case TRACE_RELEASE:
+		output_printf("-%d\n", r->arg);
+		break;
+	case TRACE_REJECT:
+		output_write("R\n", 2);
+		break;
+	default:
+		output_printf("?%d\n", r->arg);
+		break;
+	}
+}
@@ -0,0 +1,85 @@
+/**********************************************************************
+ * Copyright (c) 2019-2021
+ *  Sang-Hoon Kim <sanghoonkim@ajou.ac.kr>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTIABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ **********************************************************************/
+
+#ifndef __TRACE_H__
+#define __TRACE_H__
+
+#include <stdint.h>
+
+/**
+ * Binary event trace
+ *
+ * With "-T <trace file>", every event in the simulation is written to the
+ * trace file as a fixed-size record following struct trace_header. Records
+ * are in the host byte order. tracedump turns a trace file back into the
+ * text output.
+ */
+#define TRACE_MAGIC		"SCHEDTR2"
+#define TRACE_MAGIC_LEN	8
+
+enum trace_kind {
+	TRACE_FORK,		/* N: @pid is forked */
+	TRACE_EXIT,		/* X: @pid is finished */
+	TRACE_RUN,		/* @pid makes a progress */
+	TRACE_BLOCK,	/* =: @pid is blocked */
+	TRACE_ACQUIRE,	/* +n: @pid acquires resource @arg */
+	TRACE_RELEASE,	/* -n: @pid releases resource @arg */
+	TRACE_IDLE,		/* No process runs */
+	TRACE_REJECT,	/* R: @pid is not admitted to fork */
+};
+
+struct trace_header {
+	char magic[TRACE_MAGIC_LEN];
+	uint32_t cpu_width;		/* # of columns for a CPU. See trace_render() */
+	uint32_t reserved;
+};
+
+struct trace_record {
+	uint32_t tick;
+	uint32_t pid;
+	uint16_t kind;
+	uint16_t cpu;
+	int32_t arg;
+};
+
+/**
+ * trace_open - start writing records into @filename. Return 0 on success
+ */
+int trace_open(const char *filename);
+
+/**
+ * trace_close - write out the records buffered so far and close the trace
+ */
+void trace_close(void);
+
+/**
+ * trace_emit - put @record into the trace. Nothing happens unless opened
+ */
+void trace_emit(const struct trace_record *record);
+
+/**
+ * trace_set_cpu_width - lay out the text output of the CPUs side by side,
+ * @cpu_width columns for each
+ */
+void trace_set_cpu_width(unsigned int cpu_width);
+
+/**
+ * trace_render - print @record as in the text output. See output.h
+ *
+ * The event of process n on CPU c goes to the column (c * cpu_width + n).
+ */
+void trace_render(const struct trace_record *record);
+
+#endif
@@ -0,0 +1,83 @@
+/**********************************************************************
+ * Copyright (c) 2019-2021
+ *  Sang-Hoon Kim <sanghoonkim@ajou.ac.kr>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTIABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ **********************************************************************/
+
+/**
+ * Turn a binary event trace (sched -T) back into the text output of the
+ * simulation. The text goes to stderr as the simulator does.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "trace.h"
+#include "output.h"
+
+int main(int argc, char * const argv[])
+{
+	const struct trace_header *header;
+	const struct trace_record *r, *end;
+	struct stat st;
+	char *trace;
+	int fd;
+
+	if (argc != 2) {
+		printf("Usage: %s [trace file]\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	fd = open(argv[1], O_RDONLY);
+	if (fd < 0 || fstat(fd, &st)) {
+		fprintf(stderr, "Unable to open %s\n", argv[1]);
+		return EXIT_FAILURE;
+	}
+
+	if (st.st_size < sizeof(*header) ||
+			(st.st_size - sizeof(*header)) % sizeof(*r)) {
+		fprintf(stderr, "%s is not a trace file\n", argv[1]);
+		return EXIT_FAILURE;
+	}
+
+	trace = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (trace == MAP_FAILED) {
+		fprintf(stderr, "Unable to map %s\n", argv[1]);
+		return EXIT_FAILURE;
+	}
+	posix_madvise(trace, st.st_size, POSIX_MADV_SEQUENTIAL);
+
+	header = (const void *)trace;
+	if (memcmp(header->magic, TRACE_MAGIC, TRACE_MAGIC_LEN)) {
+		fprintf(stderr, "%s is not a trace file\n", argv[1]);
+		return EXIT_FAILURE;
+	}
+
+	output_init();
+	trace_set_cpu_width(header->cpu_width);
+
+	r = (const void *)(header + 1);
+	end = (const void *)(trace + st.st_size);
+	for (; r < end; r++) {
+		trace_render(r);
+	}
+
+	output_flush();
+	munmap(trace, st.st_size);
+
+	return EXIT_SUCCESS;
+}
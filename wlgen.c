@@ -0,0 +1,355 @@
+/**********************************************************************
+ * Copyright (c) 2019-2021
+ *  Sang-Hoon Kim <sanghoonkim@ajou.ac.kr>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTIABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ **********************************************************************/
+
+/**
+ * Synthetic workload generator. Writes a binary workload (see workload.h), or
+ * a process description script with -t, of random processes.
+ *
+ * Each process acquires at most one resource, so generated workloads never
+ * deadlock whatever the scheduler does.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <math.h>
+
+#include "types.h"
+#include "list_head.h"
+#include "heap.h"
+#include "process.h"
+#include "workload.h"
+
+#define MAX_LIFESPAN	(1 << 20)	/* Cut the heavy tail at this */
+#define PARETO_ALPHA	1.5
+
+enum arrival {
+	ARRIVAL_POISSON,	/* Exponential inter-arrival times */
+	ARRIVAL_BURSTY,		/* Bursts of processes at the same tick */
+};
+
+enum lifespan {
+	LIFESPAN_EXP,		/* Exponential */
+	LIFESPAN_PARETO,	/* Heavy-tailed */
+};
+
+static struct {
+	unsigned int nr_processes;
+	enum arrival arrival;
+	double interarrival;	/* Mean # of ticks between arrivals */
+	unsigned int burst;		/* # of processes in a burst */
+	enum lifespan lifespan;
+	double mean_lifespan;
+	unsigned int prio_spread;
+	unsigned int nr_resources;
+	double contention;		/* Probability that a process acquires one */
+	double periodic;		/* Probability that a process has a period */
+	double utilization;		/* Mean lifespan / period of periodic ones */
+	double constrained;		/* Probability that a periodic process is due
+							   before the end of its period */
+	uint64_t seed;
+	bool text;
+} opts = {
+	.nr_processes = 1000,
+	.arrival = ARRIVAL_POISSON,
+	.interarrival = 5,
+	.burst = 16,
+	.lifespan = LIFESPAN_EXP,
+	.mean_lifespan = 10,
+	.prio_spread = MAX_PRIO,
+	.nr_resources = 0,
+	.contention = 0.2,
+	.periodic = 0,
+	.utilization = 0.2,
+	.constrained = 0,
+	.seed = 1,
+	.text = false,
+};
+
+/**
+ * xorshift64*. Fast and the same on every platform for a seed
+ */
+static uint64_t __rand_state;
+
+static inline uint64_t __rand(void)
+{
+	__rand_state ^= __rand_state >> 12;
+	__rand_state ^= __rand_state << 25;
+	__rand_state ^= __rand_state >> 27;
+	return __rand_state * 2685821657736338717ULL;
+}
+
+/**
+ * Uniform in [0, 1)
+ */
+static inline double __uniform(void)
+{
+	return (__rand() >> 11) * (1.0 / (1ULL << 53));
+}
+
+/**
+ * Uniform integer in [0, n)
+ */
+static inline unsigned int __uniform_below(unsigned int n)
+{
+	return (__rand() >> 32) % n;
+}
+
+static inline double __exponential(double mean)
+{
+	return -mean * log(1.0 - __uniform());
+}
+
+/**
+ * Pareto with the shape PARETO_ALPHA scaled to have @mean
+ */
+static inline double __pareto(double mean)
+{
+	double scale = mean * (PARETO_ALPHA - 1) / PARETO_ALPHA;
+
+	return scale / pow(1.0 - __uniform(), 1.0 / PARETO_ALPHA);
+}
+
+static unsigned int __next_lifespan(void)
+{
+	double lifespan = opts.lifespan == LIFESPAN_EXP ?
+			__exponential(opts.mean_lifespan) : __pareto(opts.mean_lifespan);
+
+	if (lifespan < 1) return 1;
+	if (lifespan > MAX_LIFESPAN) return MAX_LIFESPAN;
+	return lifespan;
+}
+
+/**
+ * Period of a process running for @lifespan ticks. The utilization is drawn
+ * from (0, 2 * mean], and no more than 1
+ */
+static unsigned int __next_period(unsigned int lifespan)
+{
+	double utilization = 2 * opts.utilization * (1.0 - __uniform());
+
+	if (utilization > 1) utilization = 1;
+	return ceil(lifespan / utilization);
+}
+
+/**
+ * Fork time of the @i-th process given the previous arrival at @*clock
+ */
+static unsigned int __next_start(unsigned int i, double *clock)
+{
+	if (opts.arrival == ARRIVAL_POISSON) {
+		if (i) *clock += __exponential(opts.interarrival);
+	} else if (i && i % opts.burst == 0) {
+		*clock += __exponential(opts.interarrival * opts.burst);
+	}
+	return *clock;
+}
+
+static void __print_usage(const char *name)
+{
+	printf("Usage: %s {options} [output file]\n", name);
+	printf("\n");
+	printf("  -n [count]: # of processes (%u)\n", opts.nr_processes);
+	printf("  -a [poisson|bursty]: Arrival distribution (poisson)\n");
+	printf("  -i [ticks]: Mean inter-arrival time (%.0f)\n", opts.interarrival);
+	printf("  -b [count]: # of processes in a burst for bursty arrivals (%u)\n", opts.burst);
+	printf("  -l [exp|pareto]: Lifespan distribution (exp)\n");
+	printf("  -m [ticks]: Mean lifespan (%.0f)\n", opts.mean_lifespan);
+	printf("  -p [spread]: Priorities are drawn from [0, spread) (%u)\n", opts.prio_spread);
+	printf("  -r [count]: # of resources to contend for (%u)\n", opts.nr_resources);
+	printf("  -c [0..1]: Probability that a process acquires a resource (%.1f)\n",
+			opts.contention);
+	printf("  -e [0..1]: Probability that a process is periodic (%.1f)\n", opts.periodic);
+	printf("  -u [0..1]: Mean utilization of a periodic process (%.1f)\n", opts.utilization);
+	printf("  -d [0..1]: Probability that a periodic process is due before the end\n");
+	printf("             of its period (%.1f)\n", opts.constrained);
+	printf("  -s [seed]: Random seed (%lu)\n", (unsigned long)opts.seed);
+	printf("  -t: Write a process description script instead of a binary workload\n");
+	printf("\n");
+}
+
+static bool __parse_options(int argc, char * const argv[])
+{
+	int opt;
+
+	while ((opt = getopt(argc, argv, "n:a:i:b:l:m:p:r:c:e:u:d:s:th")) != -1) {
+		switch (opt) {
+		case 'n':
+			opts.nr_processes = strtoul(optarg, NULL, 0);
+			break;
+		case 'a':
+			if (!strcmp(optarg, "poisson")) {
+				opts.arrival = ARRIVAL_POISSON;
+			} else if (!strcmp(optarg, "bursty")) {
+				opts.arrival = ARRIVAL_BURSTY;
+			} else {
+				return false;
+			}
+			break;
+		case 'i':
+			opts.interarrival = atof(optarg);
+			break;
+		case 'b':
+			opts.burst = atoi(optarg);
+			if (opts.burst < 1) return false;
+			break;
+		case 'l':
+			if (!strcmp(optarg, "exp")) {
+				opts.lifespan = LIFESPAN_EXP;
+			} else if (!strcmp(optarg, "pareto")) {
+				opts.lifespan = LIFESPAN_PARETO;
+			} else {
+				return false;
+			}
+			break;
+		case 'm':
+			opts.mean_lifespan = atof(optarg);
+			break;
+		case 'p':
+			opts.prio_spread = atoi(optarg);
+			if (opts.prio_spread < 1 || opts.prio_spread > MAX_PRIO) return false;
+			break;
+		case 'r':
+			opts.nr_resources = atoi(optarg);
+			break;
+		case 'c':
+			opts.contention = atof(optarg);
+			break;
+		case 'e':
+			opts.periodic = atof(optarg);
+			break;
+		case 'u':
+			opts.utilization = atof(optarg);
+			if (opts.utilization <= 0 || opts.utilization > 1) return false;
+			break;
+		case 'd':
+			opts.constrained = atof(optarg);
+			break;
+		case 's':
+			opts.seed = strtoull(optarg, NULL, 0);
+			break;
+		case 't':
+			opts.text = true;
+			break;
+		case 'h':
+		default:
+			return false;
+		}
+	}
+	return optind == argc - 1;
+}
+
+int main(int argc, char * const argv[])
+{
+	struct workload_header header = {
+		.magic = WORKLOAD_MAGIC,
+	};
+	struct workload_acquire *acquires = NULL;
+	unsigned int nr_slots = 0;
+	double clock = 0;
+	FILE *file;
+
+	if (!__parse_options(argc, argv)) {
+		__print_usage(argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	/* xorshift gets stuck at 0 */
+	__rand_state = opts.seed ? opts.seed : 0x9e3779b97f4a7c15ULL;
+
+	file = fopen(argv[optind], opts.text ? "w" : "wb");
+	if (!file) {
+		fprintf(stderr, "Unable to open %s\n", argv[optind]);
+		return EXIT_FAILURE;
+	}
+
+	/* Counts are filled in at the end */
+	if (!opts.text) fwrite(&header, sizeof(header), 1, file);
+
+	for (unsigned int i = 0; i < opts.nr_processes; i++) {
+		struct workload_process wp = {
+			.pid = i + 1,
+			.start = __next_start(i, &clock),
+			.lifespan = __next_lifespan(),
+			.prio = __uniform_below(opts.prio_spread),
+			.first_acquire = header.nr_acquires,
+		};
+		struct workload_acquire wa;
+
+		if (opts.nr_resources && __uniform() < opts.contention) {
+			wa.resource_id = __uniform_below(opts.nr_resources);
+			wa.at = __uniform_below(wp.lifespan);
+			wa.duration = 1 + __uniform_below(wp.lifespan - wa.at);
+			wp.nr_acquires = 1;
+		}
+
+		/* Due by the end of the period unless constrained */
+		if (opts.periodic > 0 && __uniform() < opts.periodic) {
+			wp.period = __next_period(wp.lifespan);
+			wp.deadline = wp.period;
+			if (opts.constrained > 0 && __uniform() < opts.constrained) {
+				wp.deadline = wp.lifespan +
+						__uniform_below(wp.period - wp.lifespan + 1);
+			}
+		}
+
+		if (opts.text) {
+			fprintf(file, "process %u\n\tstart %u\n\tlifespan %u\n\tprio %u\n",
+					wp.pid, wp.start, wp.lifespan, wp.prio);
+			if (wp.period) {
+				fprintf(file, "\tperiod %u\n", wp.period);
+			}
+			if (wp.deadline != wp.period) {
+				fprintf(file, "\tdeadline %u\n", wp.deadline);
+			}
+			if (wp.nr_acquires) {
+				fprintf(file, "\tacquire %d %d %d\n",
+						wa.resource_id, wa.at, wa.duration);
+			}
+			fprintf(file, "end\n\n");
+			continue;
+		}
+
+		fwrite(&wp, sizeof(wp), 1, file);
+
+		/* Acquires follow all the processes. Keep them until then */
+		if (wp.nr_acquires) {
+			if (header.nr_acquires == nr_slots) {
+				nr_slots = nr_slots ? nr_slots * 2 : 1024;
+				acquires = realloc(acquires, sizeof(*acquires) * nr_slots);
+				if (!acquires) {
+					fprintf(stderr, "Out of memory\n");
+					return EXIT_FAILURE;
+				}
+			}
+			acquires[header.nr_acquires++] = wa;
+		}
+	}
+	header.nr_processes = opts.nr_processes;
+
+	if (!opts.text) {
+		fwrite(acquires, sizeof(*acquires), header.nr_acquires, file);
+		fseek(file, 0, SEEK_SET);
+		fwrite(&header, sizeof(header), 1, file);
+	}
+	free(acquires);
+
+	if (fclose(file)) {
+		fprintf(stderr, "Unable to write %s\n", argv[optind]);
+		return EXIT_FAILURE;
+	}
+	return EXIT_SUCCESS;
+}
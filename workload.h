@@ -0,0 +1,66 @@
+/**********************************************************************
+ * Copyright (c) 2019-2021
+ *  Sang-Hoon Kim <sanghoonkim@ajou.ac.kr>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTIABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ **********************************************************************/
+
+#ifndef __WORKLOAD_H__
+#define __WORKLOAD_H__
+
+#include <stdint.h>
+
+/**
+ * Binary workload format
+ *
+ * A binary workload describes the same processes as a process description
+ * script without any text to parse. It is laid out as;
+ *
+ *   struct workload_header
+ *   struct workload_process  processes[header.nr_processes]
+ *   struct workload_acquire  acquires[header.nr_acquires]
+ *
+ * @processes are sorted by @start, and processes starting at the same tick
+ * are in the order they appear in the script. Each process owns
+ * @nr_acquires entries of @acquires starting from @first_acquire, in the
+ * script order.
+ *
+ * All the fields are in the host byte order. Convert a script with
+ * "sched -w <workload> <script>", and give the workload to the simulator
+ * in place of the script.
+ */
+#define WORKLOAD_MAGIC		"SCHEDWL2"
+#define WORKLOAD_MAGIC_LEN	8
+
+struct workload_header {
+	char magic[WORKLOAD_MAGIC_LEN];
+	uint32_t nr_processes;
+	uint32_t nr_acquires;
+};
+
+struct workload_process {
+	uint32_t pid;
+	uint32_t start;
+	uint32_t lifespan;
+	uint32_t prio;
+	uint32_t period;
+	uint32_t deadline;		/* Relative to the fork. 0 if none */
+	uint32_t first_acquire;
+	uint32_t nr_acquires;
+};
+
+struct workload_acquire {
+	int32_t resource_id;
+	int32_t at;
+	int32_t duration;
+};
+
+#endif